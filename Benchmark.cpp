@@ -0,0 +1,412 @@
+// Benchmark driver: generates seeded graphs, runs every solver on them through the
+// vertexcover library and prints machine-readable timing and ratio tables.
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "VertexCover.h"
+
+using namespace std;
+
+typedef pair<uint32_t, uint32_t> Edge;
+
+// ------------------------ Generators ------------------------ //
+
+// GraphRng Class
+// splitmix64, so a seed gives the same graphs with every compiler and standard library
+class GraphRng
+{
+private:
+    uint64_t state;
+
+public:
+    GraphRng(uint64_t seed)
+    {
+        this->state = seed;
+    }
+
+    uint64_t next()
+    {
+        uint64_t z = (this->state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t below(uint32_t bound)
+    {
+        return this->next() % bound;
+    }
+};
+
+// Erdos-Renyi G(n, m) with m = degree * n / 2 edges drawn uniformly
+static void generate_er(uint32_t n, double degree, GraphRng &rng, vector<Edge> &edges)
+{
+    uint64_t m = degree * n / 2;
+    while (n > 1 && edges.size() < m)
+    {
+        uint32_t u = rng.below(n), v = rng.below(n);
+        if (u != v)
+            edges.push_back(Edge(u, v));
+    }
+}
+
+// Barabasi-Albert preferential attachment: every new vertex links to degree / 2 earlier
+// vertices picked proportionally to their degree, giving a power-law degree tail
+static void generate_powerlaw(uint32_t n, double degree, GraphRng &rng, vector<Edge> &edges)
+{
+    uint32_t links = std::max(1, (int)(degree / 2));
+    vector<uint32_t> endpoints;
+    for (uint32_t v = 1; v < n; v++)
+    {
+        for (uint32_t i = 0; i < links && i < v; i++)
+        {
+            // v's own earlier links put it among the endpoints, so redraw rather than loop
+            uint32_t u;
+            do
+                u = endpoints.empty() || rng.below(4) == 0 ? rng.below(v) : endpoints[rng.below(endpoints.size())];
+            while (u == v);
+            edges.push_back(Edge(u, v));
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+}
+
+// Two-dimensional grid on n vertices in row-major order
+static void generate_grid(uint32_t n, vector<Edge> &edges)
+{
+    uint32_t width = std::max<uint32_t>(1, ceil(sqrt((double)n)));
+    for (uint32_t v = 0; v < n; v++)
+    {
+        if ((v + 1) % width != 0 && v + 1 < n)
+            edges.push_back(Edge(v, v + 1));
+        if (v + width < n)
+            edges.push_back(Edge(v, v + width));
+    }
+}
+
+// Random bipartite graph between the first and the second half of the vertices
+static void generate_bipartite(uint32_t n, double degree, GraphRng &rng, vector<Edge> &edges)
+{
+    uint32_t left = n / 2;
+    uint64_t m = degree * n / 2;
+    while (left > 0 && left < n && edges.size() < m)
+        edges.push_back(Edge(rng.below(left), left + rng.below(n - left)));
+}
+
+// Random edges that all touch a hidden set of n / 4 vertices, so a cover of that size exists
+static void generate_planted(uint32_t n, double degree, GraphRng &rng, vector<Edge> &edges)
+{
+    vector<uint32_t> order(n);
+    for (uint32_t v = 0; v < n; v++)
+        order[v] = v;
+    for (uint32_t v = n; v-- > 1;)
+        std::swap(order[v], order[rng.below(v + 1)]);
+    uint32_t planted = std::max<uint32_t>(1, n / 4);
+    uint64_t m = degree * n / 2;
+    while (n > 1 && edges.size() < m)
+    {
+        uint32_t u = order[rng.below(planted)], v = rng.below(n);
+        if (u != v)
+            edges.push_back(Edge(u, v));
+    }
+}
+
+static bool generate(const string &name, uint32_t n, double degree, uint64_t seed, vector<Edge> &edges)
+{
+    GraphRng rng(seed);
+    edges.clear();
+    if (name == "er")
+        generate_er(n, degree, rng, edges);
+    else if (name == "powerlaw")
+        generate_powerlaw(n, degree, rng, edges);
+    else if (name == "grid")
+        generate_grid(n, edges);
+    else if (name == "bipartite")
+        generate_bipartite(n, degree, rng, edges);
+    else if (name == "planted")
+        generate_planted(n, degree, rng, edges);
+    else
+        return false;
+    return true;
+}
+
+// ------------------------ Benchmark ------------------------ //
+
+// Measurements of one solver on one graph
+struct BenchResult
+{
+    string solver;
+    bool exact = false;
+    size_t cover = 0;
+    bool complete = true;
+    uint32_t lower_bound = 0;
+    vector<long double> times;
+    // the first edge a run left uncovered, if any
+    bool valid = true;
+    Edge uncovered;
+};
+
+// One pass over the generated edges; false with the first uncovered edge in missed
+static bool covers_edges(uint32_t n, const vector<Edge> &edges, const vector<int> &cover, Edge &missed)
+{
+    vector<bool> in_cover(n, false);
+    for (int v : cover)
+    {
+        if (v >= 0 && (uint32_t)v < n)
+            in_cover[v] = true;
+    }
+    for (const Edge &e : edges)
+    {
+        if (!in_cover[e.first] && !in_cover[e.second])
+        {
+            missed = e;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Runs the solver once and returns its wall time in microseconds
+static long double bench_once(vc::VertexCoverSolver *solver, uint32_t n, const vector<Edge> &edges, BenchResult &result)
+{
+    vc::SolveResult run = solver->solve(vc::GraphView(n, edges));
+    Edge missed;
+    if (result.valid && !covers_edges(n, edges, run.cover, missed))
+    {
+        result.valid = false;
+        result.uncovered = missed;
+    }
+    result.cover = run.cover.size();
+    result.complete = run.optimal;
+    result.lower_bound = run.lower_bound;
+    return run.wall_time;
+}
+
+// Maximum matching between the halves of a bipartite graph by augmenting paths, which is
+// the size of its minimum vertex cover (Konig's theorem)
+static uint32_t bipartite_matching(uint32_t n, const vector<Edge> &edges)
+{
+    uint32_t left = n / 2;
+    vector<vector<uint32_t>> adj(left);
+    for (const Edge &e : edges)
+        adj[e.first].push_back(e.second);
+    vector<uint32_t> mate(n, UINT32_MAX), seen(n, UINT32_MAX);
+    uint32_t size = 0;
+    for (uint32_t root = 0; root < left; root++)
+    {
+        // depth-first search for an augmenting path, with the path kept on a stack
+        vector<pair<uint32_t, size_t>> path(1, make_pair(root, (size_t)0));
+        while (!path.empty())
+        {
+            uint32_t u = path.back().first;
+            if (path.back().second == adj[u].size())
+            {
+                path.pop_back();
+                continue;
+            }
+            uint32_t v = adj[u][path.back().second++];
+            if (seen[v] == root)
+                continue;
+            seen[v] = root;
+            if (mate[v] == UINT32_MAX)
+            {
+                // flip the matching along the path
+                for (size_t i = path.size(); i-- > 0;)
+                {
+                    uint32_t w = path[i].first, next = mate[w];
+                    mate[w] = v;
+                    mate[v] = w;
+                    v = next;
+                }
+                size++;
+                break;
+            }
+            path.push_back(make_pair(mate[v], (size_t)0));
+        }
+    }
+    return size;
+}
+
+// edges without repeats in either direction or self-loops, as the solvers' graph stores them
+static uint64_t distinct_edges(const vector<Edge> &edges)
+{
+    vector<Edge> sorted;
+    for (const Edge &e : edges)
+    {
+        if (e.first != e.second)
+            sorted.push_back(Edge(std::min(e.first, e.second), std::max(e.first, e.second)));
+    }
+    sort(sorted.begin(), sorted.end());
+    return unique(sorted.begin(), sorted.end()) - sorted.begin();
+}
+
+static string json_quote(const string &text)
+{
+    return "\"" + text + "\"";
+}
+
+int main(int argc, char *argv[])
+{
+    std::ios::sync_with_stdio(false);
+    vector<string> generators = {"er", "powerlaw", "grid", "bipartite", "planted"};
+    vector<uint32_t> sizes = {10, 20, 40};
+    double degree = 4;
+    int instances = 3, warmup = 1, reps = 5;
+    uint64_t seed = 1;
+    bool json = false, bnb = false;
+    vc::SolverOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-generators") == 0 && i + 1 < argc)
+        {
+            generators.clear();
+            stringstream list(argv[++i]);
+            string name;
+            while (getline(list, name, ','))
+                generators.push_back(name);
+        }
+        else if (strcmp(argv[i], "-sizes") == 0 && i + 1 < argc)
+        {
+            sizes.clear();
+            stringstream list(argv[++i]);
+            string size;
+            while (getline(list, size, ','))
+                sizes.push_back(strtoul(size.c_str(), NULL, 10));
+        }
+        else if (strcmp(argv[i], "-degree") == 0 && i + 1 < argc)
+            degree = atof(argv[++i]);
+        else if (strcmp(argv[i], "-instances") == 0 && i + 1 < argc)
+            instances = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-warmup") == 0 && i + 1 < argc)
+            warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-reps") == 0 && i + 1 < argc)
+            reps = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "-bnb") == 0)
+            bnb = true;
+        else if (int parsed = vc::parse_solver_option(argc, argv, i, options))
+        {
+            if (parsed < 0)
+                return EXIT_FAILURE;
+        }
+        else
+        {
+            cerr << "Error: unknown option " << argv[i] << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    vector<string> names = {"CNF-SAT-VC", "APPROX-VC-1", "APPROX-VC-2"};
+    if (bnb)
+        names.push_back("BNB-VC");
+    if (options.ls_time > 0)
+        names.push_back("LS-VC");
+    vector<unique_ptr<vc::VertexCoverSolver>> solvers;
+    for (const string &name : names)
+        solvers.push_back(unique_ptr<vc::VertexCoverSolver>(vc::make_solver(name, options)));
+
+    cout.setf(std::ios::fixed);
+    cout.precision(1);
+    if (json)
+        cout << "[" << endl;
+    else
+        cout << "generator,vertices,edges,instance,solver,cover,optimum,ratio,complete,lower_bound,runs,min_us,mean_us,max_us" << endl;
+    bool first = true;
+    vector<Edge> edges;
+    for (size_t g = 0; g < generators.size(); g++)
+    {
+        for (uint32_t n : sizes)
+        {
+            for (int instance = 0; instance < instances; instance++)
+            {
+                // every graph has its own seed, so adding generators or sizes keeps the others
+                uint64_t graph_seed = seed;
+                for (char c : generators[g])
+                    graph_seed = (graph_seed ^ (unsigned char)c) * 0x100000001b3ULL;
+                graph_seed += (uint64_t)n * 7919 + instance;
+                if (!generate(generators[g], n, degree, graph_seed, edges))
+                {
+                    cerr << "Error: unknown generator " << generators[g] << endl;
+                    return EXIT_FAILURE;
+                }
+                uint64_t edge_count = distinct_edges(edges);
+
+                vector<BenchResult> results;
+                for (unique_ptr<vc::VertexCoverSolver> &solver : solvers)
+                {
+                    BenchResult result;
+                    result.solver = solver->name();
+                    result.exact = result.solver == "CNF-SAT-VC" || result.solver == "BNB-VC";
+                    for (int w = 0; w < warmup; w++)
+                        bench_once(solver.get(), n, edges, result);
+                    for (int r = 0; r < reps; r++)
+                        result.times.push_back(bench_once(solver.get(), n, edges, result));
+                    if (!result.valid)
+                    {
+                        cerr << "Error: " << result.solver << " left edge <" << result.uncovered.first << "," << result.uncovered.second
+                             << "> uncovered on " << generators[g] << " graph " << instance << " of " << n << " vertices" << endl;
+                        return EXIT_FAILURE;
+                    }
+                    results.push_back(result);
+                }
+
+                // the optimum comes from a finished exact solver, or from Konig's theorem
+                long long optimum = -1;
+                for (const BenchResult &result : results)
+                {
+                    if (result.exact && result.complete)
+                        optimum = result.cover;
+                }
+                if (optimum == -1 && generators[g] == "bipartite")
+                    optimum = bipartite_matching(n, edges);
+
+                for (const BenchResult &result : results)
+                {
+                    long double total = 0, low = result.times[0], high = result.times[0];
+                    for (long double t : result.times)
+                    {
+                        total += t;
+                        low = std::min(low, t);
+                        high = std::max(high, t);
+                    }
+                    string ratio = optimum > 0 ? to_string((double)result.cover / optimum) : (optimum == 0 ? "1" : "");
+                    string opt = optimum >= 0 ? to_string(optimum) : "";
+                    string complete = result.exact ? (result.complete ? "1" : "0") : "";
+                    string bound = result.exact ? to_string(result.lower_bound) : "";
+                    if (json)
+                    {
+                        cout << (first ? "  " : ", ") << "{\"generator\": " << json_quote(generators[g]) << ", \"vertices\": " << n
+                             << ", \"edges\": " << edge_count << ", \"instance\": " << instance
+                             << ", \"solver\": " << json_quote(result.solver) << ", \"cover\": " << result.cover
+                             << ", \"optimum\": " << (opt.empty() ? "null" : opt) << ", \"ratio\": " << (ratio.empty() ? "null" : ratio)
+                             << ", \"complete\": " << (complete.empty() ? "null" : complete == "1" ? "true" : "false")
+                             << ", \"lower_bound\": " << (bound.empty() ? "null" : bound)
+                             << ", \"runs\": " << result.times.size() << ", \"min_us\": " << (double)low
+                             << ", \"mean_us\": " << (double)(total / result.times.size()) << ", \"max_us\": " << (double)high << "}" << endl;
+                    }
+                    else
+                    {
+                        cout << generators[g] << "," << n << "," << edge_count << "," << instance << "," << result.solver << ","
+                             << result.cover << "," << opt << "," << ratio << "," << complete << "," << bound << ","
+                             << result.times.size() << "," << (double)low << "," << (double)(total / result.times.size()) << "," << (double)high << endl;
+                    }
+                    first = false;
+                }
+            }
+        }
+    }
+    if (json)
+        cout << "]" << endl;
+    return 0;
+}
@@ -1,17 +1,29 @@
 #include <iostream>
 #include <sstream>
-#include <regex>
+#include <fstream>
 #include <vector>
+#include <map>
+#include <list>
+#include <deque>
+#include <algorithm>
 #include <pthread.h>
 #include <unistd.h>
 #include <time.h>
 #include <errno.h>
 #include <math.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <string.h>
+#include <stdio.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
-// Minisat requirements
-#include <memory>
-#include "minisat/core/SolverTypes.h"
-#include "minisat/core/Solver.h"
+// graph storage and the solvers
+#include "Solvers.h"
+
+using namespace std;
+using namespace vc;
 
 //error handlers for getcpuclockid()
 #define handle_error(msg)   \
@@ -29,432 +41,738 @@
         exit(EXIT_FAILURE);      \
     } while (0)
 
-using namespace std;
-
-// ------------------------ Storage Class Structures ------------------------ //
-
-// Node Class
-class Node
+// ------------------------ Input Parsing ------------------------ //
+// One tokenizer and one reader per input format, shared by the stored graph and -stream.
+// The readers take characters from an Input (StreamReader or LineReader: peek(), get(),
+// column(), line()) and hand every edge to a callback, which either appends it to an edge
+// list or feeds it to a StreamCover.
+
+// StreamReader Class
+// Buffered reader over a file descriptor, one character at a time. Tracks the byte offset,
+// for seeking back to a graph, and the column within the current line, for error messages.
+// Files are read through it whether or not the graph is stored.
+class StreamReader
 {
 private:
-    int id;
-    vector<Node *> nodes;
+    int fd = -1;
+    bool owned = false;
+    vector<char> buffer;
+    size_t pos = 0, len = 0;
+    uint64_t consumed = 0;
+    size_t line_column = 0;
+    uint64_t line_number = 1;
+
+    bool fill()
+    {
+        if (this->pos < this->len)
+            return true;
+        ssize_t got;
+        do
+            got = read(this->fd, this->buffer.data(), this->buffer.size());
+        while (got < 0 && errno == EINTR);
+        this->pos = 0;
+        this->len = got > 0 ? got : 0;
+        return this->len > 0;
+    }
 
 public:
-    Node(int _id)
+    StreamReader() : buffer(1 << 20)
     {
-        this->id = _id;
     }
 
-    int get_id()
+    ~StreamReader()
     {
-        return this->id;
+        if (this->owned)
+            close(this->fd);
     }
 
-    vector<Node *> get_nodes()
+    bool open(const string &path)
     {
-        return this->nodes;
+        this->fd = ::open(path.c_str(), O_RDONLY);
+        this->owned = this->fd >= 0;
+        return this->owned;
     }
 
-    void connect(Node *n)
+    // offsets count from where fd is now, when it can seek at all
+    void attach(int fd)
     {
-        this->nodes.push_back(n);
+        this->fd = fd;
+        off_t offset = lseek(fd, 0, SEEK_CUR);
+        this->consumed = offset > 0 ? offset : 0;
     }
 
-    void disconnect(Node *other)
+    // A position to come back to with seek(): the offset, and the line state there
+    struct Mark
     {
-        for (unsigned int i = 0; i < this->nodes.size(); i++)
-        {
-            if (this->nodes[i]->id == other->id)
-            {
-                this->nodes.erase(this->nodes.begin() + i);
-                break;
-            }
-        }
+        uint64_t offset;
+        size_t column;
+        uint64_t line;
+    };
+
+    Mark mark() const
+    {
+        Mark mark = {this->consumed, this->line_column, this->line_number};
+        return mark;
+    }
+
+    bool seek(const Mark &mark)
+    {
+        if (lseek(this->fd, mark.offset, SEEK_SET) != (off_t)mark.offset)
+            return false;
+        this->pos = this->len = 0;
+        this->consumed = mark.offset;
+        this->line_column = mark.column;
+        this->line_number = mark.line;
+        return true;
+    }
+
+    int peek()
+    {
+        return this->fill() ? (unsigned char)this->buffer[this->pos] : EOF;
     }
 
-    bool isConnected(Node *n)
+    int get()
     {
-        for (Node *item : this->nodes)
+        if (!this->fill())
+            return EOF;
+        int c = (unsigned char)this->buffer[this->pos++];
+        this->consumed++;
+        this->line_column++;
+        if (c == '\n')
         {
-            if (item->id == n->id)
-                return true;
+            this->line_column = 0;
+            this->line_number++;
         }
-        return false;
+        return c;
+    }
+
+    // 0-based position in the current line
+    size_t column() const
+    {
+        return this->line_column;
     }
 
-    int degree()
+    uint64_t line() const
     {
-        return this->nodes.size();
+        return this->line_number;
     }
 };
 
-// Graph Class
-class Graph
+// LineReader Class
+// The Input interface over one line already in memory, from pos on
+class LineReader
 {
 private:
-    vector<Node *> nodes;
+    const string &text;
+    size_t pos;
 
 public:
-    vector<Node *> get_nodes()
+    LineReader(const string &text, size_t pos) : text(text), pos(pos)
     {
-        return this->nodes;
     }
 
-    void fill(int number)
+    int peek() const
     {
-        for (int id = 0; id < number; id++)
-            nodes.push_back(new Node(id));
+        return this->pos < this->text.size() ? (unsigned char)this->text[this->pos] : EOF;
     }
 
-    void clear()
+    int get()
     {
-        for (Node *item : nodes)
-        {
-            delete item;
-        }
-        nodes.clear();
+        return this->pos < this->text.size() ? (unsigned char)this->text[this->pos++] : EOF;
     }
 
-    Node *findNode(int id)
+    size_t column() const
     {
-        for (Node *item : nodes)
-        {
-            if (item->get_id() == id)
-                return item;
-        }
-        return NULL;
+        return this->pos;
     }
 
-    void ConnectNodes(Node *n1, Node *n2)
+    uint64_t line() const
     {
-        if (!n1->isConnected(n2))
-            n1->connect(n2);
-        if (!n2->isConnected(n1))
-            n2->connect(n1);
+        return 1;
     }
+};
+
+// spaces and tabs, never the end of the line
+template <class Input>
+static void skip_blanks(Input &in)
+{
+    int c;
+    while ((c = in.peek()) != EOF && c != '\n' && isspace(c))
+        in.get();
+}
+
+template <class Input>
+static void skip_line(Input &in)
+{
+    int c;
+    while ((c = in.get()) != EOF && c != '\n')
+        ;
+}
+
+// saturates past UINT32_MAX so huge ids still fail the range check
+template <class Input>
+static bool read_number(Input &in, uint64_t &value)
+{
+    if (in.peek() == EOF || !isdigit(in.peek()))
+        return false;
+    value = 0;
+    while (in.peek() != EOF && isdigit(in.peek()))
+        value = std::min<uint64_t>(value * 10 + (in.get() - '0'), (uint64_t)UINT32_MAX + 1);
+    return true;
+}
+
+// Parser
+// Single pass over "{<a,b>,<c,d>,...}", handing every edge to edge(u, v). Blanks between
+// tokens are allowed. Stops at the first problem, after the edges before it, and describes
+// it in error together with its 1-based column.
+template <class Input, class EdgeFn>
+static bool read_edges(Input &in, uint32_t v_count, EdgeFn edge, string &error)
+{
+    auto expect = [&](char c) {
+        skip_blanks(in);
+        if (in.peek() != c)
+            return false;
+        in.get();
+        skip_blanks(in);
+        return true;
+    };
+    auto fail = [&](const string &message, size_t column) {
+        error = "Error: " + message + " at column " + to_string(column + 1);
+        return false;
+    };
 
-    void DisconnectNodes(Node *n1, Node *n2)
+    if (!expect('{'))
+        return fail("expected '{'", in.column());
+    if (in.peek() == '}')
+        in.get();
+    else
     {
-        if (n1->isConnected(n2))
-            n1->disconnect(n2);
-        if (n2->isConnected(n1))
-            n2->disconnect(n1);
+        while (true)
+        {
+            size_t column = in.column();
+            uint64_t node1_id, node2_id;
+            if (!expect('<'))
+                return fail("expected '<'", in.column());
+            if (!read_number(in, node1_id))
+                return fail("expected a node number", in.column());
+            if (!expect(','))
+                return fail("expected ','", in.column());
+            if (!read_number(in, node2_id))
+                return fail("expected a node number", in.column());
+            if (!expect('>'))
+                return fail("expected '>'", in.column());
+            if (node1_id == node2_id)
+                return fail("a node can't get connected to itself", column);
+            if (node1_id >= v_count || node2_id >= v_count)
+                return fail("node number is out of range", column);
+            edge(node1_id, node2_id);
+
+            if (in.peek() == ',')
+                in.get();
+            else if (in.peek() == '}')
+            {
+                in.get();
+                break;
+            }
+            else
+                return fail("expected ',' or '}'", in.column());
+        }
     }
+    skip_blanks(in);
+    if (in.peek() != '\n' && in.peek() != EOF)
+        return fail("unexpected text after '}'", in.column());
+    return true;
+}
+
+// The edges of line from pos on, appended to edges
+static bool parser(const string &line, size_t pos, uint32_t v_count, vector<Edge> &edges, string &error)
+{
+    // "<a,b>," is the shortest edge, so this never has to grow
+    edges.reserve(edges.size() + (line.size() - pos) / 6 + 1);
+    LineReader in(line, pos);
+    return read_edges(in, v_count, [&](uint32_t u, uint32_t v) { edges.push_back(Edge(u, v)); }, error);
+}
 
-    int degree()
+// Graph file formats accepted by -input
+enum FileFormat
+{
+    FORMAT_AUTO,
+    FORMAT_DIMACS,
+    FORMAT_METIS,
+    FORMAT_BINARY
+};
+
+// Picks the format from the extension: .gr/.clq/.col are DIMACS, .graph/.metis are METIS
+static FileFormat detect_format(const string &path)
+{
+    size_t dot = path.rfind('.');
+    string ext = dot == string::npos ? "" : path.substr(dot + 1);
+    if (ext == "gr" || ext == "clq" || ext == "col" || ext == "dimacs")
+        return FORMAT_DIMACS;
+    if (ext == "graph" || ext == "metis")
+        return FORMAT_METIS;
+    if (ext == "vcsr")
+        return FORMAT_BINARY;
+    return FORMAT_AUTO;
+}
+
+// Reads a DIMACS shortest-path (.gr: "p sp n m", "a u v w") or clique/colouring
+// (.clq/.col: "p edge n m", "e u v") file. Ids are 1-based, self-loops are dropped. The
+// problem line sets v_count and calls header(n, m); edges go to edge(u, v) 0-based.
+template <class Input, class HeaderFn, class EdgeFn>
+static bool read_dimacs(Input &in, const string &path, uint32_t &v_count, HeaderFn header_fn, EdgeFn edge, string &error)
+{
+    bool header = false;
+    int c;
+    while ((c = in.peek()) != EOF)
     {
-        int graph_degree = 0;
-        for (Node *item : this->nodes)
+        uint64_t number = in.line();
+        if (c == '\n' || c == 'c')
+        {
+            skip_line(in);
+            continue;
+        }
+        in.get();
+        skip_blanks(in);
+        if (c == 'p')
+        {
+            // the problem kind is not checked
+            while (in.peek() != EOF && !isspace(in.peek()))
+                in.get();
+            skip_blanks(in);
+            uint64_t n, m;
+            bool valid = !header && read_number(in, n);
+            skip_blanks(in);
+            if (!valid || !read_number(in, m) || n > INT32_MAX)
+            {
+                error = "Error: bad problem line in " + path + ":" + to_string(number);
+                return false;
+            }
+            v_count = n;
+            header_fn(n, m);
+            header = true;
+        }
+        else if (c == 'a' || c == 'e')
+        {
+            uint64_t u = 0, v = 0;
+            bool valid = read_number(in, u);
+            skip_blanks(in);
+            valid = valid && read_number(in, v);
+            if (!valid || !header || u == 0 || v == 0 || u > v_count || v > v_count)
+            {
+                error = "Error: bad edge in " + path + ":" + to_string(number);
+                return false;
+            }
+            if (u != v)
+                edge(u - 1, v - 1);
+        }
+        else
         {
-            int temp_degree = item->degree();
-            if (graph_degree < temp_degree)
-                graph_degree = temp_degree;
+            error = "Error: unknown line in " + path + ":" + to_string(number);
+            return false;
         }
-        return graph_degree;
+        skip_line(in);
+    }
+    if (!header)
+    {
+        error = "Error: " + path + " has no problem line";
+        return false;
     }
+    return true;
+}
 
-    Node *degreeNode()
+// Reads a METIS graph: header "n m [fmt [ncon]]" then one 1-based adjacency line per
+// vertex. Vertex sizes, vertex weights and edge weights are parsed and ignored. The header
+// sets v_count and calls header(n, m); every edge goes to edge(u, v) once, 0-based.
+template <class Input, class HeaderFn, class EdgeFn>
+static bool read_metis(Input &in, const string &path, uint32_t &v_count, HeaderFn header_fn, EdgeFn edge, string &error)
+{
+    auto next = [&]() {
+        while (in.peek() == '%')
+            skip_line(in);
+        return in.peek() != EOF;
+    };
+    auto field = [&](uint64_t &value) {
+        skip_blanks(in);
+        return read_number(in, value);
+    };
+
+    uint64_t n = 0, m = 0, fmt = 0, ncon = 0;
+    if (!next() || !field(n) || !field(m) || n > INT32_MAX)
+    {
+        error = "Error: bad METIS header in " + path;
+        return false;
+    }
+    if (field(fmt))
+        field(ncon);
+    skip_line(in);
+    bool sizes = fmt / 100 % 10, weights = fmt / 10 % 10, edge_weights = fmt % 10;
+    if (weights && ncon == 0)
+        ncon = 1;
+    if (!weights)
+        ncon = 0;
+
+    v_count = n;
+    header_fn(n, m);
+    for (uint32_t v = 0; v < n; v++)
     {
-        int graph_degree = 0;
-        Node *result;
-        for (Node *item : this->nodes)
+        if (!next())
+        {
+            error = "Error: " + path + " ends before vertex " + to_string(v + 1);
+            return false;
+        }
+        uint64_t number = in.line(), value;
+        for (uint64_t skip = sizes + ncon; skip > 0; skip--)
+            field(value);
+        uint64_t u;
+        while (field(u))
         {
-            int temp_degree = item->degree();
-            if (graph_degree < temp_degree)
+            if (u == 0 || u > n)
             {
-                graph_degree = temp_degree;
-                result = item;
+                error = "Error: bad neighbour in " + path + ":" + to_string(number);
+                return false;
             }
+            if (edge_weights)
+                field(value);
+            // both directions are listed, keep each edge once
+            if (v < u - 1)
+                edge(v, u - 1);
         }
-        return result;
+        skip_line(in);
     }
-};
+    return true;
+}
 
-// Parser
-vector<string> parser(string input)
+// Reads a DIMACS or METIS file into edges
+static bool load_text_graph(const string &path, FileFormat format, uint32_t &v_count, vector<Edge> &edges, string &error)
 {
-    vector<string> parsedInput;
-    std::string s(input);
-    std::smatch m;
-    std::regex e("<[0-9]+,[0-9]+>");
-
-    while (std::regex_search(s, m, e))
+    StreamReader in;
+    if (!in.open(path))
     {
-        for (auto x : m)
-            parsedInput.push_back(x);
-        s = m.suffix().str();
+        error = "Error: cannot open " + path;
+        return false;
     }
-    return parsedInput;
+    auto header = [&](uint64_t, uint64_t m) { edges.reserve(m); };
+    auto edge = [&](uint32_t u, uint32_t v) { edges.push_back(Edge(u, v)); };
+    if (format == FORMAT_DIMACS)
+        return read_dimacs(in, path, v_count, header, edge, error);
+    return read_metis(in, path, v_count, header, edge, error);
 }
 
-// SingleCalcDetail
-class SingleCalcDetail
+// RunningStats
+// Welford's online mean and variance, so no sample has to be kept
+class RunningStats
 {
 private:
-    long double ratio;
-    long double runtime;
+    uint64_t count = 0;
+    long double mean = 0, m2 = 0;
 
 public:
-    SingleCalcDetail(long double runtime)
+    void add(long double value)
     {
-        this->ratio = -1;
-        this->runtime = runtime;
+        this->count++;
+        long double delta = value - this->mean;
+        this->mean += delta / this->count;
+        this->m2 += delta * (value - this->mean);
     }
-    SingleCalcDetail(long double ratio, long double runtime)
+    uint64_t get_count() const
     {
-        this->ratio = ratio;
-        this->runtime = runtime;
+        return this->count;
     }
-    long double get_ratio()
+    long double get_mean() const
     {
-        return this->ratio;
+        return this->count > 0 ? this->mean : -1;
     }
-    long double get_runtime()
+    long double get_deviation() const
     {
-        return this->runtime;
+        return this->count > 0 ? sqrtl(this->m2 / this->count) : -1;
     }
 };
 
-// CalcData
-class CalcData
+// LatencyHistogram
+// Runtimes in log-spaced buckets, eight per power of two, so a percentile is off by at
+// most 1/8 of its value while the memory stays fixed however many graphs are solved
+class LatencyHistogram
 {
+private:
+    static const int BUCKETS = 8 * 62;
+    vector<uint64_t> buckets;
+    uint64_t count = 0;
+    uint64_t max = 0;
+
+    static int bucket(uint64_t value)
+    {
+        if (value < 8)
+            return value;
+        int exponent = 63 - __builtin_clzll(value);
+        return 8 * (exponent - 2) + ((value >> (exponent - 3)) & 7);
+    }
+    // largest value that falls into bucket i
+    static uint64_t upper(int i)
+    {
+        if (i < 8)
+            return i;
+        uint64_t step = 1ULL << (i / 8 - 1);
+        return (uint64_t)(8 + i % 8) * step + (step - 1);
+    }
+
 public:
-    int count_ratio, count_runtime;
-    long double avg_ratio, avg_runtime, deviation_ratio, deviation_runtime;
-    string Ratio_toString()
-    {
-        string output = "";
-        output += "\tCount Ratio: " + to_string(this->count_ratio) + "\n";
-        output += "\t\tAvg Ratio: " + to_string(this->avg_ratio) + "\n";
-        output += "\t\tDeviation Ratio: " + to_string(this->deviation_ratio) + "\n";
-        return output;
+    void add(long double value)
+    {
+        uint64_t v = value > 0 ? (uint64_t)llroundl(value) : 0;
+        if (this->buckets.empty())
+            this->buckets.assign(BUCKETS, 0);
+        this->buckets[bucket(v)]++;
+        this->count++;
+        this->max = std::max(this->max, v);
     }
-    string Runtime_toString()
+    // upper end of the bucket holding the q-quantile, -1 without samples
+    long double percentile(double q) const
     {
-        string output = "";
-        output += "\tCount Runtime: " + to_string(this->count_runtime) + "\n";
-        output += "\t\tAvg Runtime: " + to_string(this->avg_runtime) + "\n";
-        output += "\t\tDeviation Runtime: " + to_string(this->deviation_runtime) + "\n";
-        return output;
+        if (this->count == 0)
+            return -1;
+        uint64_t rank = std::max<uint64_t>(1, ceil(q * this->count)), seen = 0;
+        for (int i = 0; i < BUCKETS; i++)
+        {
+            seen += this->buckets[i];
+            if (seen >= rank)
+                return std::min(upper(i), this->max);
+        }
+        return this->max;
+    }
+    long double get_max() const
+    {
+        return this->count > 0 ? this->max : -1;
     }
 };
 
-// CalcStorage
-class CalcStorage
+// CalcAccumulator
+// Ratio and runtime statistics of one algorithm at one vertex count
+class CalcAccumulator
 {
-private:
-    vector<SingleCalcDetail *> CNF_SAT;
-    vector<SingleCalcDetail *> APPROX_1;
-    vector<SingleCalcDetail *> APPROX_2;
-    CalcData *data_CNF = new CalcData();
-    CalcData *data_APPROX_1 = new CalcData();
-    CalcData *data_APPROX_2 = new CalcData();
-
 public:
-    int vCount;
-    CalcStorage(int vCount)
-    {
-        this->vCount = vCount;
-    }
+    RunningStats ratio, runtime;
+    LatencyHistogram latency;
+    uint64_t timeouts = 0;
 
-    void add_cnf(SingleCalcDetail *item)
+    // runtime of a run whose cover could not be compared with an exact one
+    void add(long double runtime, bool timeout = false)
     {
-        this->CNF_SAT.push_back(item);
+        this->runtime.add(runtime);
+        this->latency.add(runtime);
+        if (timeout)
+            this->timeouts++;
     }
-    void add_app1(SingleCalcDetail *item)
+    // a ratio of -1 (no exact cover to compare with) only counts the runtime
+    void add(long double ratio, long double runtime)
     {
-        this->APPROX_1.push_back(item);
+        if (ratio >= 0)
+            this->ratio.add(ratio);
+        this->add(runtime);
     }
-    void add_app2(SingleCalcDetail *item)
+    uint64_t runs() const
     {
-        this->APPROX_2.push_back(item);
+        return this->runtime.get_count();
     }
-    void calc()
-    {
-        long double total_sum, count, temp;
-        //CNF_SAT
-        this->data_CNF->count_ratio = (long double)this->CNF_SAT.size();
-        this->data_CNF->count_runtime = (long double)this->CNF_SAT.size();
-        if (this->CNF_SAT.size() > 0)
-        {
-            //ratio
-            this->data_CNF->avg_ratio = 1;
-            this->data_CNF->deviation_ratio = 0;
+};
 
-            //runtime
-            total_sum = 0;
-            for (SingleCalcDetail *item : this->CNF_SAT)
-                total_sum += item->get_runtime();
-            this->data_CNF->avg_runtime = total_sum / this->data_CNF->count_runtime;
+enum CalcAlgorithm
+{
+    CALC_CNF,
+    CALC_APPROX_1,
+    CALC_APPROX_2,
+    CALC_BNB,
+    CALC_LS,
+    CALC_KERNEL,
+    CALC_COUNT
+};
 
-            total_sum = 0;
-            for (SingleCalcDetail *item : this->CNF_SAT)
-                total_sum += pow(item->get_runtime() - this->data_CNF->avg_runtime, 2);
-            this->data_CNF->deviation_runtime = sqrtl(total_sum / this->data_CNF->count_runtime);
-        }
-        else
-        {
-            this->data_CNF->avg_ratio = -1;
-            this->data_CNF->deviation_ratio = -1;
-            this->data_CNF->avg_runtime = -1;
-            this->data_CNF->deviation_runtime = -1;
-        }
+// Output of -calc on exit
+enum CalcFormat
+{
+    CALC_TEXT,
+    CALC_CSV,
+    CALC_JSON
+};
 
-        //APPROX_1
-        if (this->APPROX_1.size() > 0)
-        {
-            //ratio
-            total_sum = 0;
-            count = 0;
-            for (SingleCalcDetail *item : this->APPROX_1)
-            {
-                temp = item->get_ratio();
-                if (temp != -1)
-                {
-                    count++;
-                    total_sum += temp;
-                }
-            }
-            this->data_APPROX_1->count_ratio = count;
-            if (count > 0)
-                this->data_APPROX_1->avg_ratio = total_sum / count;
-            else
-                this->data_APPROX_1->avg_ratio = -1;
+// CalcStorage
+// All statistics of one vertex count
+class CalcStorage
+{
+private:
+    CalcAccumulator items[CALC_COUNT];
 
-            total_sum = 0;
-            for (SingleCalcDetail *item : this->APPROX_1)
-            {
-                temp = item->get_ratio();
-                if (temp != -1)
-                    total_sum += pow(temp - this->data_APPROX_1->avg_ratio, 2);
-            }
-            if (count > 0)
-                this->data_APPROX_1->deviation_ratio = sqrtl(total_sum / count);
-            else
-                this->data_APPROX_1->deviation_ratio = -1;
+    // the text report always lists the three base algorithms, the others once they ran
+    bool shown(int id) const
+    {
+        return id <= CALC_APPROX_2 || this->items[id].runs() > 0;
+    }
+    static string text_name(int id, bool ratio)
+    {
+        static const char *labels[CALC_COUNT] = {"CNF-SAT", "APPROX-1", "APPROX-2", "BNB", "LS", "KERNEL"};
+        if (id == CALC_KERNEL)
+            return ratio ? "KERNEL (kernel vertices / vertex count)" : "KERNEL (reduction)";
+        return labels[id];
+    }
+    static string number(long double value)
+    {
+        return value < 0 ? "" : to_string((double)value);
+    }
+    static string json_number(long double value)
+    {
+        return value < 0 ? "null" : to_string((double)value);
+    }
 
-            //runtime
-            total_sum = 0;
-            this->data_APPROX_1->count_runtime = (long double)this->APPROX_1.size();
-            for (SingleCalcDetail *item : this->APPROX_1)
-                total_sum += item->get_runtime();
-            this->data_APPROX_1->avg_runtime = total_sum / this->data_APPROX_1->count_runtime;
+public:
+    static const char *names[CALC_COUNT];
+    int vCount;
+    // -cache lookups; a hit answers CNF-SAT-VC and BNB-VC without running them
+    uint64_t cache_hits = 0, cache_misses = 0;
+    CalcStorage(int vCount)
+    {
+        this->vCount = vCount;
+    }
 
-            total_sum = 0;
-            for (SingleCalcDetail *item : this->APPROX_1)
-                total_sum += pow(item->get_runtime() - this->data_APPROX_1->avg_runtime, 2);
-            this->data_APPROX_1->deviation_runtime = sqrtl(total_sum / this->data_APPROX_1->count_runtime);
-        }
-        else
-        {
-            this->data_APPROX_1->avg_ratio = -1;
-            this->data_APPROX_1->deviation_ratio = -1;
-            this->data_APPROX_1->avg_runtime = -1;
-            this->data_APPROX_1->deviation_runtime = -1;
-        }
+    CalcAccumulator &item(CalcAlgorithm id)
+    {
+        return this->items[id];
+    }
 
-        //APPROX_2
-        if (this->APPROX_2.size() > 0)
+    string Ratio_toString() const
+    {
+        string output = "vertex count: " + to_string(this->vCount);
+        for (int id = 0; id < CALC_COUNT; id++)
         {
-            //ratio
-            total_sum = 0;
-            count = 0;
-            for (SingleCalcDetail *item : this->APPROX_2)
-            {
-                temp = item->get_ratio();
-                if (temp != -1)
-                {
-                    count++;
-                    total_sum += temp;
-                }
-            }
-            this->data_APPROX_2->count_ratio = count;
-            if (count > 0)
-                this->data_APPROX_2->avg_ratio = total_sum / count;
-            else
-                this->data_APPROX_2->avg_ratio = -1;
-
-            total_sum = 0;
-            for (SingleCalcDetail *item : this->APPROX_2)
-            {
-                temp = item->get_ratio();
-                if (temp != -1)
-                    total_sum += pow(temp - this->data_APPROX_2->avg_ratio, 2);
-            }
-            if (count > 0)
-                this->data_APPROX_2->deviation_ratio = sqrtl(total_sum / count);
-            else
-                this->data_APPROX_2->deviation_ratio = -1;
-
-            //runtime
-            total_sum = 0;
-            this->data_APPROX_2->count_runtime = (long double)this->APPROX_2.size();
-            for (SingleCalcDetail *item : this->APPROX_2)
-                total_sum += item->get_runtime();
-            this->data_APPROX_2->avg_runtime = total_sum / this->data_APPROX_2->count_runtime;
-
-            total_sum = 0;
-            for (SingleCalcDetail *item : this->APPROX_2)
-                total_sum += pow(item->get_runtime() - this->data_APPROX_2->avg_runtime, 2);
-            this->data_APPROX_2->deviation_runtime = sqrtl(total_sum / this->data_APPROX_2->count_runtime);
+            if (!this->shown(id))
+                continue;
+            const RunningStats &ratio = this->items[id].ratio;
+            output += "\n\t" + text_name(id, true) + ":\n";
+            output += "\tCount Ratio: " + to_string(ratio.get_count()) + "\n";
+            output += "\t\tAvg Ratio: " + to_string(ratio.get_mean()) + "\n";
+            output += "\t\tDeviation Ratio: " + to_string(ratio.get_deviation()) + "\n";
         }
-        else
+        return output;
+    }
+    string Runtime_toString() const
+    {
+        string output = "vertex count: " + to_string(this->vCount);
+        for (int id = 0; id < CALC_COUNT; id++)
         {
-            this->data_APPROX_2->avg_ratio = -1;
-            this->data_APPROX_2->deviation_ratio = -1;
-            this->data_APPROX_2->avg_runtime = -1;
-            this->data_APPROX_2->deviation_runtime = -1;
+            if (!this->shown(id))
+                continue;
+            const CalcAccumulator &item = this->items[id];
+            output += "\n\t" + text_name(id, false) + ":\n";
+            output += "\tCount Runtime: " + to_string(item.runs()) + "\n";
+            output += "\t\tAvg Runtime: " + to_string(item.runtime.get_mean()) + "\n";
+            output += "\t\tDeviation Runtime: " + to_string(item.runtime.get_deviation()) + "\n";
+            output += "\t\tP50 / P90 / P99 / Max Runtime: " + to_string(item.latency.percentile(0.5)) + " / " +
+                      to_string(item.latency.percentile(0.9)) + " / " + to_string(item.latency.percentile(0.99)) + " / " +
+                      to_string(item.latency.get_max()) + "\n";
+            if (id == CALC_CNF || id == CALC_BNB)
+                output += "\t\tTimeouts: " + to_string(item.timeouts) + "\n";
+            if (id == CALC_CNF && this->cache_hits + this->cache_misses > 0)
+                output += "\t\tCache Hits / Misses: " + to_string(this->cache_hits) + " / " + to_string(this->cache_misses) + "\n";
         }
+        return output;
     }
-
-    string Runtime_toString()
+    // the cache counts go with CNF-SAT-VC, which may only have been answered from the cache
+    bool cached(int id) const
     {
-        string output = "vertex count: " + to_string(this->vCount);
-        output += "\n\tCNF-SAT:\n";
-        output += this->data_CNF->Runtime_toString();
-        output += "\n\tAPPROX-1:\n";
-        output += this->data_APPROX_1->Runtime_toString();
-        output += "\n\tAPPROX-2:\n";
-        output += this->data_APPROX_2->Runtime_toString();
+        return id == CALC_CNF && this->cache_hits + this->cache_misses > 0;
+    }
+    // one row per algorithm that ran; empty fields have no samples
+    string to_csv() const
+    {
+        string output;
+        for (int id = 0; id < CALC_COUNT; id++)
+        {
+            const CalcAccumulator &item = this->items[id];
+            if (item.runs() == 0 && !this->cached(id))
+                continue;
+            output += to_string(this->vCount) + "," + names[id] + "," + to_string(item.runs()) + "," + to_string(item.timeouts) + "," +
+                      to_string(item.ratio.get_count()) + "," + number(item.ratio.get_mean()) + "," + number(item.ratio.get_deviation()) + "," +
+                      number(item.runtime.get_mean()) + "," + number(item.runtime.get_deviation()) + "," +
+                      number(item.latency.percentile(0.5)) + "," + number(item.latency.percentile(0.9)) + "," +
+                      number(item.latency.percentile(0.99)) + "," + number(item.latency.get_max()) + "," +
+                      (this->cached(id) ? to_string(this->cache_hits) + "," + to_string(this->cache_misses) : ",") + "\n";
+        }
         return output;
     }
-    string Ratio_toString()
+    // JSON objects of the algorithms that ran, each followed by a comma
+    string to_json() const
     {
-        string output = "vertex count: " + to_string(this->vCount);
-        output += "\n\tCNF-SAT:\n";
-        output += this->data_CNF->Ratio_toString();
-        output += "\n\tAPPROX-1:\n";
-        output += this->data_APPROX_1->Ratio_toString();
-        output += "\n\tAPPROX-2:\n";
-        output += this->data_APPROX_2->Ratio_toString();
+        string output;
+        for (int id = 0; id < CALC_COUNT; id++)
+        {
+            const CalcAccumulator &item = this->items[id];
+            if (item.runs() == 0 && !this->cached(id))
+                continue;
+            string cache = this->cached(id) ? ", \"cache_hits\": " + to_string(this->cache_hits) + ", \"cache_misses\": " + to_string(this->cache_misses) : "";
+            output += "  {\"vertices\": " + to_string(this->vCount) + ", \"algorithm\": \"" + names[id] + "\", \"runs\": " + to_string(item.runs()) +
+                      ", \"timeouts\": " + to_string(item.timeouts) + ", \"ratio_count\": " + to_string(item.ratio.get_count()) +
+                      ", \"ratio_mean\": " + json_number(item.ratio.get_mean()) + ", \"ratio_stddev\": " + json_number(item.ratio.get_deviation()) +
+                      ", \"runtime_mean_us\": " + json_number(item.runtime.get_mean()) + ", \"runtime_stddev_us\": " + json_number(item.runtime.get_deviation()) +
+                      ", \"p50_us\": " + json_number(item.latency.percentile(0.5)) + ", \"p90_us\": " + json_number(item.latency.percentile(0.9)) +
+                      ", \"p99_us\": " + json_number(item.latency.percentile(0.99)) + ", \"max_us\": " + json_number(item.latency.get_max()) + cache + "},\n";
+        }
         return output;
     }
 };
+const char *CalcStorage::names[CALC_COUNT] = {"CNF-SAT-VC", "APPROX-VC-1", "APPROX-VC-2", "BNB-VC", "LS-VC", "KERNEL"};
+
+// -cachemode: keys over the input ids, or over canonical ids from colour refinement
+enum CacheMode
+{
+    CACHE_EXACT,
+    CACHE_WL
+};
+
+// Outcome of the -cache lookup for one graph
+enum CacheLookup
+{
+    LOOKUP_NONE,
+    LOOKUP_HIT,
+    LOOKUP_MISS
+};
 
 // ------------------------ Global Variables ------------------------ //
 int v_Count = 0;
 bool calc_mode = false;
+CalcFormat calc_format = CALC_TEXT;
+// -trace events of the whole process; options.tracer points here
+Tracer tracer;
+// solver options from the command line, handed to every run
+SolverOptions options;
+bool bnb_mode = false;
+vector<string> input_files;
+FileFormat input_format = FORMAT_AUTO;
+string save_path;
+string trace_path;
+string serve_path;
+bool perf_mode = false;
+int batch_threads = 0;
 Graph *graph = new Graph();
-Graph *graph_approx_1 = new Graph();
-Graph *graph_approx_2 = new Graph();
-pthread_t cnf_sat_vc, approx_vc_1, approx_vc_2;
-long double time_cnf_sat, time_approx1, time_approx2;
+vector<Edge> edge_list;
+vector<Component> components;
+pthread_t cnf_sat_vc, approx_vc_1, approx_vc_2, bnb_vc, ls_vc;
+long double time_cnf_sat, time_approx1, time_approx2, time_kernel, time_bnb, time_ls;
+uint32_t kernel_vertices;
+uint32_t cnf_lower_bound, bnb_lower_bound;
 
-vector<int> result_cnf, result_approx_1, result_approx_2;
+vector<int> result_cnf, result_approx_1, result_approx_2, result_bnb, result_ls;
 
-vector<CalcStorage *> calc_data;
+map<int, CalcStorage> calc_data;
 bool hasTimedOut = false;
-
-// ------------------------ Time Execution related Functions ------------------------ //
-static long double pclock(clockid_t cid)
-{
-    struct timespec ts;
-    if (clock_gettime(cid, &ts) == -1)
-        handle_error("clock_gettime");
-
-    return (ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
-}
+bool bnbTimedOut = false;
+CacheLookup cache_lookup = LOOKUP_NONE;
+size_t cache_size = 0;
+CacheMode cache_mode = CACHE_EXACT;
+string cache_path;
+bool stream_mode = false;
+bool stream_prune = false;
+// the result globals hold covers of the current graph, usable as warm starts
+bool has_solution = false;
+GraphEdit graph_edit;
 
 // ------------------------ Approximation Ratio related Functions ------------------------ //
 static long double approx_ratio(float input, float base)
@@ -466,182 +784,129 @@ static long double approx_ratio(float input, float base)
     return input / base;
 }
 
-// ------------------------ 3 Solvers Implementation ------------------------ //
-// CNF-SAT-VC
+// ------------------------ Solver Threads ------------------------ //
+// reset before each graph and cancelled by the IO thread when the time budget runs out
+SolveControl cnf_control, bnb_control;
+
 void *CNF_SAT_VC(void *arg)
 {
-    // Initializing min, max
-    int min = 1, max = v_Count;
+    TraceScope trace(&tracer, "CNF-SAT-VC", "solver");
+    SolveStats stats;
+    exact_cover(&cnf_sat_vc_exact, graph, components, result_cnf, &stats, &cnf_control);
+    time_kernel = stats.kernel_time;
+    kernel_vertices = stats.kernel_vertices;
+    hasTimedOut = !stats.complete;
+    cnf_lower_bound = stats.lower_bound;
 
-    std::unique_ptr<Minisat::Solver> solver(new Minisat::Solver());
-    int n = v_Count;
-    //for (int k = v_Count - graph_degree-2; k <= v_Count; k++)
-    int k;
-    while (min <= max)
+    //Calc Mode
+    if (calc_mode == true)
     {
-        k = (min + max) / 2;
-        // creating the literal table
-        vector<vector<Minisat::Lit>> literals_table;
-
-        vector<Minisat::Lit> tempRow;
-        for (int i = 0; i < n; i++)
-        {
-            tempRow.clear();
-            for (int j = 0; j < k; j++)
-            {
-                tempRow.push_back(Minisat::mkLit(solver->newVar()));
-            }
-            literals_table.push_back(tempRow);
-        }
-
-        Minisat::vec<Minisat::Lit> tempClause;
-        // Reduction: part 1
-        for (int j = 0; j < k; j++)
-        {
-            tempClause.clear();
-            for (int i = 0; i < n; i++)
-            {
-                tempClause.push(literals_table[i][j]);
-            }
-            solver->addClause(tempClause);
-        }
-
-        // Reduction: part 2
-        for (int m = 0; m < n; m++)
-        {
-            for (int q = 1; q < k; q++)
-            {
-                for (int p = 0; p < q; p++)
-                    solver->addClause(~literals_table[m][p], ~literals_table[m][q]);
-            }
-        }
-
-        // Reduction: part 3
-        for (int m = 0; m < k; m++)
-        {
-            for (int q = 1; q < n; q++)
-            {
-                for (int p = 0; p < q; p++)
-                    solver->addClause(~literals_table[p][m], ~literals_table[q][m]);
-            }
-        }
-
-        // Reduction: part 4
-        for (Node *i_item : graph->get_nodes())
+        clockid_t cid;
+        int s = pthread_getcpuclockid(cnf_sat_vc, &cid);
+        if (s != 0)
         {
-            for (Node *j_item : i_item->get_nodes())
-            {
-                int i_id = i_item->get_id();
-                int j_id = j_item->get_id();
-                if (i_id < j_id)
-                {
-                    tempClause.clear();
-                    for (int j = 0; j < k; j++)
-                    {
-                        tempClause.push(literals_table[i_id][j]);
-                        tempClause.push(literals_table[j_id][j]);
-                    }
-                    solver->addClause(tempClause);
-                }
-            }
+            handle_error_en(s, "pthread_getcpuclockid");
         }
+        time_cnf_sat = pclock(cid);
+    }
+    return NULL;
+}
 
-        bool res = solver->solve();
-        if (res == 0)
-        {
-            min = k + 1;
-        }
-        else
-        {
-            max = k - 1;
-            result_cnf.clear();
-            for (int i = 0; i < n; i++)
-            {
-                for (int j = 0; j < k; j++)
-                {
-                    if (Minisat::toInt(solver->modelValue(literals_table[i][j])) == 0)
-                    {
-                        result_cnf.push_back(i);
-                        break;
-                    }
-                }
-            }
-        }
+// BNB-VC
+void *BNB_VC(void *arg)
+{
+    TraceScope trace(&tracer, "BNB-VC", "solver");
+    SolveStats stats;
+    exact_cover(&bnb_vc_exact, graph, components, result_bnb, &stats, &bnb_control);
+    bnbTimedOut = !stats.complete;
+    bnb_lower_bound = stats.lower_bound;
 
-        //de-allocates existing solver and allocates a new one in its place.
-        solver.reset(new Minisat::Solver());
-    }
     //Calc Mode
     if (calc_mode == true)
     {
         clockid_t cid;
-        int s = pthread_getcpuclockid(cnf_sat_vc, &cid);
+        int s = pthread_getcpuclockid(bnb_vc, &cid);
         if (s != 0)
         {
             handle_error_en(s, "pthread_getcpuclockid");
         }
-        time_cnf_sat = pclock(cid);
+        time_bnb = pclock(cid);
     }
     return NULL;
 }
 
-// APPROX_VC_1
-void *APPROX_VC_1(void *arg)
+void *LS_VC(void *arg)
 {
-    result_approx_1.clear();
-    while (graph_approx_1->degree() > 0)
+    TraceScope trace(&tracer, "LS-VC", "solver");
+    if (graph_edit.active)
+    {
+        // restart from the previous local optimum rather than the greedy cover
+        vector<int> start;
+        start.swap(result_ls);
+        repair_cover(graph, graph_edit, false, start);
+        ls_vc_search(graph, start, options.ls_time, result_ls);
+    }
+    else
     {
-        Node *target = graph_approx_1->degreeNode();
-        result_approx_1.push_back(target->get_id());
-        for (Node *item : target->get_nodes())
-            graph_approx_1->DisconnectNodes(target, item);
+        result_ls.clear();
+        ls_vc_cover(graph, options.ls_time, result_ls);
     }
 
     //Calc Mode
     if (calc_mode == true)
     {
         clockid_t cid;
-        int s = pthread_getcpuclockid(approx_vc_1, &cid);
+        int s = pthread_getcpuclockid(ls_vc, &cid);
         if (s != 0)
         {
             handle_error_en(s, "pthread_getcpuclockid");
         }
-        time_approx1 = pclock(cid);
+        time_ls = pclock(cid);
     }
     return NULL;
 }
 
-// APPROX_VC_2
-void *APPROX_VC_2(void *arg)
+// APPROX_VC_1
+void *APPROX_VC_1(void *arg)
 {
-    vector<int> result;
-    result_approx_2.clear();
-    while (graph_approx_2->degree() > 0)
+    TraceScope trace(&tracer, "APPROX-VC-1", "solver");
+    if (graph_edit.active)
+        repair_cover(graph, graph_edit, false, result_approx_1);
+    else
     {
-        //selecting a node with the highest degree in our graph
-        Node *target_1 = graph_approx_2->degreeNode();
+        result_approx_1.clear();
+        max_degree_greedy_cover(graph, result_approx_1);
+    }
+    if (options.bounds)
+        cnf_control.offer(result_approx_1);
 
-        //selecting a node with the highest degree among all nodes that are connected to the target_1 node
-        int temp_degree = 0;
-        Node *target_2;
-        for (Node *item : target_1->get_nodes())
+    //Calc Mode
+    if (calc_mode == true)
+    {
+        clockid_t cid;
+        int s = pthread_getcpuclockid(approx_vc_1, &cid);
+        if (s != 0)
         {
-            if (temp_degree < item->degree())
-            {
-                temp_degree = item->degree();
-                target_2 = item;
-            }
+            handle_error_en(s, "pthread_getcpuclockid");
         }
+        time_approx1 = pclock(cid);
+    }
+    return NULL;
+}
 
-        result_approx_2.push_back(target_1->get_id());
-        result_approx_2.push_back(target_2->get_id());
-
-        for (Node *item : target_1->get_nodes())
-            graph_approx_2->DisconnectNodes(target_1, item);
-
-        for (Node *item : target_2->get_nodes())
-            graph_approx_2->DisconnectNodes(target_2, item);
+// APPROX_VC_2
+void *APPROX_VC_2(void *arg)
+{
+    TraceScope trace(&tracer, "APPROX-VC-2", "solver");
+    if (graph_edit.active)
+        repair_cover(graph, graph_edit, true, result_approx_2);
+    else
+    {
+        result_approx_2.clear();
+        approx_vc_2_cover(graph, edge_list, options.approx2, result_approx_2);
     }
+    if (options.bounds)
+        cnf_control.offer(result_approx_2);
 
     //Calc Mode
     if (calc_mode == true)
@@ -658,208 +923,1865 @@ void *APPROX_VC_2(void *arg)
 }
 
 // ------------------------ Calc Function ------------------------ //
-static void Calc()
+static void Calc(int count)
 {
-    // calc mode
-    bool isExist = false;
-    CalcStorage *cur;
-    for (CalcStorage *item : calc_data)
+    map<int, CalcStorage>::iterator it = calc_data.find(count);
+    if (it == calc_data.end())
+        it = calc_data.insert(make_pair(count, CalcStorage(count))).first;
+    CalcStorage &cur = it->second;
+    if (cache_lookup == LOOKUP_HIT)
+        cur.cache_hits++;
+    else if (cache_lookup == LOOKUP_MISS)
+        cur.cache_misses++;
+
+    // either exact solver gives the base for the approximation ratios; a cache hit has no
+    // exact runtimes to record
+    bool solved = cache_lookup != LOOKUP_HIT;
+    bool hasBnb = bnb_mode && !bnbTimedOut;
+    const vector<int> &exact = !hasTimedOut ? result_cnf : result_bnb;
+    if (solved && !hasTimedOut)
     {
-        if (item->vCount == v_Count)
-        {
-            isExist = true;
-            cur = item;
-            break;
-        }
-    }
-    if (!isExist)
-    {
-        cur = new CalcStorage(v_Count);
-        calc_data.push_back(cur);
+        cur.item(CALC_CNF).add(1, time_cnf_sat);
+        if (options.kernel)
+            cur.item(CALC_KERNEL).add(approx_ratio(float(kernel_vertices), float(count)), time_kernel);
     }
-    if (!hasTimedOut)
+    else if (solved)
+        cur.item(CALC_CNF).add(time_cnf_sat, true);
+    if (!hasTimedOut || hasBnb)
     {
-        cur->add_cnf(new SingleCalcDetail(1, time_cnf_sat));
-        cur->add_app1(new SingleCalcDetail(approx_ratio(float(result_approx_1.size()), float(result_cnf.size())), time_approx1));
-        cur->add_app2(new SingleCalcDetail(approx_ratio(float(result_approx_2.size()), float(result_cnf.size())), time_approx2));
+        cur.item(CALC_APPROX_1).add(approx_ratio(float(result_approx_1.size()), float(exact.size())), time_approx1);
+        cur.item(CALC_APPROX_2).add(approx_ratio(float(result_approx_2.size()), float(exact.size())), time_approx2);
     }
     else
     {
-        cur->add_app1(new SingleCalcDetail(time_approx1));
-        cur->add_app2(new SingleCalcDetail(time_approx2));
+        cur.item(CALC_APPROX_1).add(time_approx1);
+        cur.item(CALC_APPROX_2).add(time_approx2);
     }
+    if (solved && hasBnb)
+        cur.item(CALC_BNB).add(approx_ratio(float(result_bnb.size()), float(exact.size())), time_bnb);
+    else if (solved && bnb_mode)
+        cur.item(CALC_BNB).add(time_bnb, true);
+    if (options.ls_time > 0 && (!hasTimedOut || hasBnb))
+        cur.item(CALC_LS).add(approx_ratio(float(result_ls.size()), float(exact.size())), time_ls);
+    else if (options.ls_time > 0)
+        cur.item(CALC_LS).add(time_ls);
 }
-// ------------------------ Printer Function ------------------------ //
-static void Printer()
+
+// Prints the collected statistics in the -calcformat on exit
+static void print_calc()
 {
-    //CNF-SAT-VC
-    string output = "CNF-SAT-VC: ";
-    if (hasTimedOut)
+    if (calc_format == CALC_CSV)
     {
-        output += "timeout\n";
+        cout << "vertices,algorithm,runs,timeouts,ratio_count,ratio_mean,ratio_stddev,runtime_mean_us,runtime_stddev_us,p50_us,p90_us,p99_us,max_us,cache_hits,cache_misses" << endl;
+        for (const auto &item : calc_data)
+            cout << item.second.to_csv();
+        cout.flush();
+        return;
     }
-    else
+    if (calc_format == CALC_JSON)
     {
-        sort(result_cnf.begin(), result_cnf.end());
-        for (int id : result_cnf)
-        {
-            output += to_string(id) + ",";
-        }
-        output = output.substr(0, output.length() - 1) + "\n";
+        string output;
+        for (const auto &item : calc_data)
+            output += item.second.to_json();
+        if (!output.empty())
+            output.erase(output.size() - 2, 1); // comma after the last object
+        cout << "[\n" << output << "]" << endl;
+        return;
     }
-
-    //APPROX-VC-1
-    output += "APPROX-VC-1: ";
-    sort(result_approx_1.begin(), result_approx_1.end());
-    for (int id : result_approx_1)
+    cout << "=================== Calc Mode Start ===================" << endl;
+    cout << "========= Ratio =========" << endl;
+    for (const auto &item : calc_data)
+    {
+        cout << item.second.Ratio_toString() << endl;
+        cout << "---------------" << endl;
+    }
+    cout << "========= Runtime =========" << endl;
+    for (const auto &item : calc_data)
+    {
+        cout << item.second.Runtime_toString() << endl;
+        cout << "---------------" << endl;
+    }
+    cout << "=================== Calc Mode End ===================" << endl;
+}
+// ------------------------ Printer Function ------------------------ //
+// Best cover found before a timeout and the proven lower bound, e.g. "1,3,4 (lower bound 2)"
+static string anytime_toString(vector<int> &cover, uint32_t lower_bound)
+{
+    sort(cover.begin(), cover.end());
+    string output;
+    for (int id : cover)
     {
         output += to_string(id) + ",";
     }
-    output = output.substr(0, output.length() - 1) + "\n";
+    if (!output.empty())
+        output.pop_back();
+    return output + " (lower bound " + to_string(lower_bound) + ")\n";
+}
 
-    //APPROX-VC-2
-    output += "APPROX-VC-2: ";
-    sort(result_approx_2.begin(), result_approx_2.end());
-    for (int id : result_approx_2)
+// One output line, e.g. "APPROX-VC-1: 1,3,4", or the best cover so far after a timeout
+static string cover_toString(const char *name, vector<int> &cover, bool timedOut = false, uint32_t lower_bound = 0)
+{
+    string output = string(name) + ": ";
+    if (timedOut)
+        return output + "timeout " + anytime_toString(cover, lower_bound);
+    sort(cover.begin(), cover.end());
+    for (int id : cover)
     {
         output += to_string(id) + ",";
     }
-    output = output.substr(0, output.length() - 1) + "\n";
+    return output.substr(0, output.length() - 1) + "\n";
+}
 
+static void Printer()
+{
+    TraceScope trace(&tracer, "print", "io");
+    string output = cover_toString("CNF-SAT-VC", result_cnf, hasTimedOut, cnf_lower_bound);
+    output += cover_toString("APPROX-VC-1", result_approx_1);
+    output += cover_toString("APPROX-VC-2", result_approx_2);
+    if (bnb_mode)
+        output += cover_toString("BNB-VC", result_bnb, bnbTimedOut, bnb_lower_bound);
+    if (options.ls_time > 0)
+        output += cover_toString("LS-VC", result_ls);
     cout << output;
 }
 
-// ------------------------ IO Thread ------------------------ //
-void *I_O(void *arg)
+// ------------------------ Result Cache ------------------------ //
+// With -cache N the exact results of the last N distinct graphs are kept, keyed by a hash of
+// the edge set that does not depend on edge order. A graph whose entry holds a proven
+// optimum skips the exact solvers; any other entry warm-starts them with its cover and
+// lower bound. -cachemode wl also recognises relabelled repeats, and -cachefile keeps the
+// entries across runs.
+
+// splitmix64 finaliser
+static uint64_t mix64(uint64_t x)
 {
-    char cmd;
-    while (!cin.eof())
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// CacheKey
+// 128 bits of edge set hash. labels maps vertices to canonical ids, UINT32_MAX for
+// isolated vertices, and is empty when the key is over the input ids.
+struct CacheKey
+{
+    pair<uint64_t, uint64_t> hash;
+    vector<uint32_t> labels;
+};
+
+// ResultCache Class
+// LRU map from CacheKey to the best cover and lower bound known for the graph, in the key's
+// ids. Shared by every thread that solves, under its own lock.
+class ResultCache
+{
+private:
+    struct Entry
     {
+        pair<uint64_t, uint64_t> hash;
+        uint32_t lower_bound;
+        vector<uint32_t> cover;
+    };
+
+    size_t capacity;
+    CacheMode mode;
+    // most recently used first
+    list<Entry> entries;
+    map<pair<uint64_t, uint64_t>, list<Entry>::iterator> index;
+    pthread_mutex_t lock;
+
+    // Colour refinement: starting from the degrees, every round hashes each vertex's colour
+    // with the multiset of its neighbours' colours, until the number of colours stops growing.
+    // The colours never depend on the ids, so when they tell all non-isolated vertices apart,
+    // their order is a canonical labelling. False when they do not.
+    template <class G>
+    static bool refine(const G *graph, vector<uint32_t> &labels)
+    {
+        uint32_t n = graph->vertexCount();
+        vector<uint64_t> colour(n), next(n), sorted;
+        for (uint32_t v = 0; v < n; v++)
+            colour[v] = graph->degree(v);
+        size_t classes = 0;
+        for (uint32_t round = 0; round <= n; round++)
+        {
+            sorted.clear();
+            for (uint32_t v = 0; v < n; v++)
+            {
+                if (graph->degree(v) > 0)
+                    sorted.push_back(colour[v]);
+            }
+            sort(sorted.begin(), sorted.end());
+            size_t count = unique(sorted.begin(), sorted.end()) - sorted.begin();
+            if (count == sorted.size())
+                break;
+            if (count == classes)
+                return false;
+            classes = count;
+            for (uint32_t v = 0; v < n; v++)
+            {
+                uint64_t sum = 0;
+                for (const typename G::Id *it = graph->begin(v); it != graph->end(v); ++it)
+                    sum += mix64(colour[*it]);
+                next[v] = mix64(colour[v] ^ mix64(sum));
+            }
+            colour.swap(next);
+        }
+        sorted.resize(unique(sorted.begin(), sorted.end()) - sorted.begin());
+        labels.assign(n, UINT32_MAX);
+        for (uint32_t v = 0; v < n; v++)
+        {
+            if (graph->degree(v) > 0)
+                labels[v] = lower_bound(sorted.begin(), sorted.end(), colour[v]) - sorted.begin();
+        }
+        return true;
+    }
 
-        string line;
-        getline(cin, line);
+    void insert(const pair<uint64_t, uint64_t> &hash, uint32_t lower_bound, vector<uint32_t> &cover)
+    {
+        map<pair<uint64_t, uint64_t>, list<Entry>::iterator>::iterator it = this->index.find(hash);
+        if (it != this->index.end())
+        {
+            // keep the best of both: the smaller cover and the larger bound
+            Entry &entry = *it->second;
+            entry.lower_bound = std::max(entry.lower_bound, lower_bound);
+            if (cover.size() < entry.cover.size())
+                entry.cover.swap(cover);
+            this->entries.splice(this->entries.begin(), this->entries, it->second);
+            return;
+        }
+        this->entries.push_front(Entry());
+        Entry &entry = this->entries.front();
+        entry.hash = hash;
+        entry.lower_bound = lower_bound;
+        entry.cover.swap(cover);
+        this->index[hash] = this->entries.begin();
+        if (this->entries.size() > this->capacity)
+        {
+            this->index.erase(this->entries.back().hash);
+            this->entries.pop_back();
+        }
+    }
 
-        istringstream input(line);
-        input >> cmd;
-        if (input.eof())
-            break;
+    template <class G>
+    void key(const G *graph, CacheKey &key) const
+    {
+        key.labels.clear();
+        bool canonical = this->mode == CACHE_WL && refine(graph, key.labels);
+        if (!canonical)
+            key.labels.clear();
+        // a sum of per-edge hashes is the same for every edge order
+        uint64_t h1 = 0, h2 = 0;
+        for (uint32_t v = 0; v < graph->vertexCount(); v++)
+        {
+            for (const typename G::Id *it = graph->begin(v); it != graph->end(v); ++it)
+            {
+                if (*it < v)
+                    continue;
+                uint64_t a = canonical ? key.labels[v] : v, b = canonical ? key.labels[*it] : *it;
+                uint64_t edge = std::min(a, b) << 32 | std::max(a, b);
+                h1 += mix64(edge);
+                h2 += mix64(edge ^ 0x5bd1e9955bd1e995ULL);
+            }
+        }
+        key.hash = make_pair(mix64(h1 ^ graph->edgeCount()), mix64(h2 + canonical));
+    }
 
-        string edges;
-        switch (cmd)
+    template <class G>
+    static bool covers(const G *graph, const vector<bool> &in_cover)
+    {
+        for (uint32_t v = 0; v < graph->vertexCount(); v++)
         {
-        case 'V':
+            for (const typename G::Id *it = graph->begin(v); it != graph->end(v); ++it)
+            {
+                if (!in_cover[v] && !in_cover[*it])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    ResultCache(size_t capacity, CacheMode mode) : capacity(capacity), mode(mode)
+    {
+        pthread_mutex_init(&this->lock, NULL);
+    }
+
+    ~ResultCache()
+    {
+        pthread_mutex_destroy(&this->lock);
+    }
+
+    // O(m) in exact mode, plus the refinement rounds in wl mode
+    void key(const Graph *graph, CacheKey &key) const
+    {
+        CSR_DISPATCH(graph, view, this->key(view, key));
+    }
+
+    // The cached cover of graph in its own ids and its lower bound; false when there is none
+    // or the cover does not fit the graph, which only a hash collision can cause. cover and
+    // lower_bound are left untouched unless the lookup succeeds.
+    bool lookup(const Graph *graph, const CacheKey &key, vector<int> &cover, uint32_t &lower_bound)
+    {
+        vector<uint32_t> stored;
+        uint32_t stored_lower = 0;
+        pthread_mutex_lock(&this->lock);
+        map<pair<uint64_t, uint64_t>, list<Entry>::iterator>::iterator it = this->index.find(key.hash);
+        bool found = it != this->index.end();
+        if (found)
         {
-            input >> v_Count;
-            graph->clear();
-            graph_approx_1->clear();
-            graph_approx_2->clear();
-            graph->fill(v_Count);
-            graph_approx_1->fill(v_Count);
-            graph_approx_2->fill(v_Count);
-            break;
+            stored = it->second->cover;
+            stored_lower = it->second->lower_bound;
+            this->entries.splice(this->entries.begin(), this->entries, it->second);
         }
-        case 'E':
+        pthread_mutex_unlock(&this->lock);
+        if (!found)
+            return false;
+
+        uint32_t n = graph->vertexCount();
+        vector<uint32_t> vertex;
+        if (!key.labels.empty())
         {
-            bool hasVertex = false;
-            input >> edges;
-            for (string item : parser(edges))
+            vertex.assign(n, UINT32_MAX);
+            for (uint32_t v = 0; v < n; v++)
             {
-                int seperator = item.find(",");
-                int node1_id = stoi(item.substr(1, seperator - 1));
-                int node2_id = stoi(item.substr(seperator + 1, item.length() - (seperator + 2)));
-                if (node1_id == node2_id)
-                {
-                    cout << "Error: a node can't get connected to itself" << endl;
-                    break;
-                }
-                if (node1_id >= v_Count || node1_id < 0 || node2_id >= v_Count || node2_id < 0)
-                {
-                    cout << "Error: node number is out of range" << endl;
-                    break;
-                }
-                graph->ConnectNodes(graph->findNode(node1_id), graph->findNode(node2_id));
-                graph_approx_1->ConnectNodes(graph_approx_1->findNode(node1_id), graph_approx_1->findNode(node2_id));
-                graph_approx_2->ConnectNodes(graph_approx_2->findNode(node1_id), graph_approx_2->findNode(node2_id));
-                hasVertex = true;
+                if (key.labels[v] != UINT32_MAX)
+                    vertex[key.labels[v]] = v;
             }
+        }
+        vector<bool> in_cover(n, false);
+        vector<int> mapped;
+        for (uint32_t id : stored)
+        {
+            uint32_t v = vertex.empty() ? id : id < n ? vertex[id] : UINT32_MAX;
+            if (v >= n)
+                return false;
+            in_cover[v] = true;
+            mapped.push_back(v);
+        }
+        bool valid = false;
+        CSR_DISPATCH(graph, view, valid = covers(view, in_cover));
+        if (!valid)
+            return false;
+        cover.swap(mapped);
+        lower_bound = stored_lower;
+        return true;
+    }
+
+    // Records a cover of the keyed graph with its proven lower bound
+    void store(const CacheKey &key, const vector<int> &cover, uint32_t lower_bound)
+    {
+        vector<uint32_t> stored;
+        for (int v : cover)
+        {
+            // isolated vertices have no canonical id and are never needed in a cover
+            if (key.labels.empty())
+                stored.push_back(v);
+            else if (key.labels[v] != UINT32_MAX)
+                stored.push_back(key.labels[v]);
+        }
+        pthread_mutex_lock(&this->lock);
+        this->insert(key.hash, lower_bound, stored);
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    // Layout: "VCCH", version, entry count, then per entry from least recently used: the two
+    // hash words, lower bound, cover size and cover ids, all in host byte order
+    bool save(const string &path)
+    {
+        string temp = path + ".tmp";
+        FILE *out = fopen(temp.c_str(), "wb");
+        if (out == NULL)
+            return false;
+        pthread_mutex_lock(&this->lock);
+        uint32_t header[3] = {0, 1, (uint32_t)this->entries.size()};
+        memcpy(header, "VCCH", 4);
+        bool ok = fwrite(header, 4, 3, out) == 3;
+        for (list<Entry>::reverse_iterator it = this->entries.rbegin(); ok && it != this->entries.rend(); ++it)
+        {
+            uint64_t hash[2] = {it->hash.first, it->hash.second};
+            uint32_t sizes[2] = {it->lower_bound, (uint32_t)it->cover.size()};
+            ok = fwrite(hash, 8, 2, out) == 2 && fwrite(sizes, 4, 2, out) == 2 &&
+                 fwrite(it->cover.data(), 4, it->cover.size(), out) == it->cover.size();
+        }
+        pthread_mutex_unlock(&this->lock);
+        ok = fclose(out) == 0 && ok;
+        return ok && rename(temp.c_str(), path.c_str()) == 0;
+    }
 
-            hasTimedOut = false;
-            if (hasVertex)
+    // Adds the entries of a file written by save(); a missing file is an empty cache
+    bool load(const string &path, string &error)
+    {
+        FILE *in = fopen(path.c_str(), "rb");
+        if (in == NULL)
+            return true;
+        uint32_t header[3];
+        bool ok = fread(header, 4, 3, in) == 3 && memcmp(header, "VCCH", 4) == 0 && header[1] == 1;
+        for (uint32_t i = 0; ok && i < header[2]; i++)
+        {
+            uint64_t hash[2];
+            uint32_t sizes[2];
+            ok = fread(hash, 8, 2, in) == 2 && fread(sizes, 4, 2, in) == 2 && sizes[1] <= INT32_MAX;
+            vector<uint32_t> cover(ok ? sizes[1] : 0);
+            ok = ok && fread(cover.data(), 4, cover.size(), in) == cover.size();
+            if (ok)
             {
-                pthread_create(&cnf_sat_vc, NULL, &CNF_SAT_VC, NULL);
-                pthread_create(&approx_vc_1, NULL, &APPROX_VC_1, NULL);
-                pthread_create(&approx_vc_2, NULL, &APPROX_VC_2, NULL);
+                pthread_mutex_lock(&this->lock);
+                this->insert(make_pair(hash[0], hash[1]), sizes[0], cover);
+                pthread_mutex_unlock(&this->lock);
+            }
+        }
+        fclose(in);
+        if (!ok)
+            error = "Error: " + path + " is not a cache file";
+        return ok;
+    }
+};
 
-                struct timespec ts;
+ResultCache *cache = NULL;
 
-                if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
-                {
-                    handle_error("CLOCK_REALTIME");
-                }
-                ts.tv_sec += 10;
-                int s = pthread_timedjoin_np(cnf_sat_vc, NULL, &ts);
-                if (s != 0)
-                {
-                    hasTimedOut = true;
-                    result_cnf.clear();
-                }
-                pthread_join(approx_vc_1, NULL);
-                pthread_join(approx_vc_2, NULL);
+// ------------------------ Batch Pipeline ------------------------ //
+// With -batch N the IO thread only parses: every E command becomes a job whose
+// solvers run as separate tasks on N persistent workers, and a writer thread
+// prints the finished jobs in input order.
+
+enum BatchTask
+{
+    TASK_CNF,
+    TASK_APPROX_1,
+    TASK_APPROX_2,
+    TASK_BNB,
+    TASK_LS,
+    TASK_COUNT
+};
+
+// BatchJob: one E command (or one error message) travelling through the pipeline
+struct BatchJob
+{
+    string message;
+    bool solve = false;
+    bool hasVertex = false;
+    int v_count = 0;
+    // seconds the exact solvers get, 0 for -timeout
+    double budget = 0;
+    // -cache: the graph's key, and the cached cover and bound that answer or seed the exact tasks
+    CacheKey key;
+    CacheLookup lookup = LOOKUP_NONE;
+    vector<int> warm;
+    uint32_t warm_lower = 0;
+    Graph graph;
+    vector<Edge> edges;
+    vector<Component> components;
+    SolveStats stats[TASK_COUNT];
+    SolveControl control[TASK_COUNT];
+    vector<int> covers[TASK_COUNT];
+    long double times[TASK_COUNT] = {};
+    bool queued[TASK_COUNT] = {};
+    bool done[TASK_COUNT] = {};
+    bool started[TASK_COUNT] = {};
+    bool cancelled[TASK_COUNT] = {};
+    struct timespec deadline[TASK_COUNT];
+    int pending = 0;
+    bool printed = false;
+};
+
+// BNB-VC and LS-VC only run, and print, when enabled on the command line
+static bool task_enabled(int task)
+{
+    return (task != TASK_BNB || bnb_mode) && (task != TASK_LS || options.ls_time > 0);
+}
+
+// The output lines of a finished job
+static string job_toString(BatchJob *job)
+{
+    string output;
+    for (int task = 0; task < TASK_COUNT; task++)
+    {
+        if (task_enabled(task))
+            output += cover_toString(CalcStorage::names[task], job->covers[task], !job->stats[task].complete, job->stats[task].lower_bound);
+    }
+    return output;
+}
+
+class BatchPipeline
+{
+private:
+    deque<BatchJob *> jobs;
+    deque<pair<BatchJob *, int>> tasks;
+    size_t window;
+    bool closing = false;
+    pthread_mutex_t lock;
+    pthread_cond_t task_ready, job_ready, space;
+    vector<pthread_t> workers;
+    pthread_t writer;
+
+    static void runTask(BatchJob *job, int task, vector<int> &cover)
+    {
+        // the task order matches the -calc algorithms
+        TraceScope trace(&tracer, CalcStorage::names[task], "solver");
+        switch (task)
+        {
+        case TASK_CNF:
+            exact_cover(&cnf_sat_vc_exact, &job->graph, job->components, cover, &job->stats[task], &job->control[task]);
+            break;
+        case TASK_APPROX_1:
+            max_degree_greedy_cover(&job->graph, cover);
+            break;
+        case TASK_APPROX_2:
+            approx_vc_2_cover(&job->graph, job->edges, options.approx2, cover);
+            break;
+        case TASK_BNB:
+            exact_cover(&bnb_vc_exact, &job->graph, job->components, cover, &job->stats[task], &job->control[task]);
+            break;
+        case TASK_LS:
+            ls_vc_cover(&job->graph, options.ls_time, cover);
+            break;
+        }
+    }
+
+    // a job is deleted by whichever of the writer and its last task finishes second
+    void release(BatchJob *job)
+    {
+        if (job->printed && job->pending == 0)
+            delete job;
+    }
+
+    void work()
+    {
+        pthread_mutex_lock(&this->lock);
+        while (true)
+        {
+            while (this->tasks.empty() && !this->closing)
+                pthread_cond_wait(&this->task_ready, &this->lock);
+            if (this->tasks.empty())
+                break;
+            BatchJob *job = this->tasks.front().first;
+            int task = this->tasks.front().second;
+            this->tasks.pop_front();
+            // the exact solvers get the time budget from the moment they start
+            if (!budget_deadline(job->budget > 0 ? job->budget : options.time_budget, job->deadline[task]))
+                handle_error("CLOCK_REALTIME");
+            job->started[task] = true;
+            // the writer or a server client may be waiting on this job without a deadline yet
+            pthread_cond_broadcast(&this->job_ready);
+            pthread_mutex_unlock(&this->lock);
+
+            vector<int> cover;
+            long double start = pclock(CLOCK_THREAD_CPUTIME_ID);
+            runTask(job, task, cover);
+            long double elapsed = pclock(CLOCK_THREAD_CPUTIME_ID) - start;
+            if (options.bounds && (task == TASK_APPROX_1 || task == TASK_APPROX_2))
+                job->control[TASK_CNF].offer(cover);
+            if (job->lookup == LOOKUP_MISS && (task == TASK_CNF || task == TASK_BNB))
+                cache->store(job->key, cover, job->stats[task].lower_bound);
+
+            pthread_mutex_lock(&this->lock);
+            job->covers[task].swap(cover);
+            job->times[task] = elapsed;
+            job->done[task] = true;
+            job->pending--;
+            pthread_cond_broadcast(&this->job_ready);
+            this->release(job);
+        }
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    // true when every task is done; exact solvers past their deadline are cancelled,
+    // and then finish shortly with their best cover so far
+    bool ready(BatchJob *job, struct timespec *wake)
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        bool ready = true;
+        for (int task = 0; task < TASK_COUNT; task++)
+        {
+            if (!job->queued[task] || job->done[task])
+                continue;
+            ready = false;
+            bool exact = task == TASK_CNF || task == TASK_BNB;
+            if (!exact || !job->started[task] || job->cancelled[task])
+                continue;
+            const struct timespec &d = job->deadline[task];
+            if (now.tv_sec < d.tv_sec || (now.tv_sec == d.tv_sec && now.tv_nsec < d.tv_nsec))
+            {
+                if (wake->tv_sec == 0 || d.tv_sec < wake->tv_sec || (d.tv_sec == wake->tv_sec && d.tv_nsec < wake->tv_nsec))
+                    *wake = d;
             }
             else
             {
-                result_cnf.clear();
-                result_approx_1.clear();
-                result_approx_2.clear();
+                job->cancelled[task] = true;
+                job->control[task].cancel();
             }
-            if (calc_mode)
-                Calc();
+        }
+        return ready;
+    }
 
-            Printer();
+    void print(BatchJob *job)
+    {
+        if (!job->message.empty())
+            cout << job->message << endl;
+        if (!job->solve)
+            return;
+
+        // the writer is the only thread touching the result globals in batch mode
+        hasTimedOut = !job->stats[TASK_CNF].complete;
+        bnbTimedOut = !job->stats[TASK_BNB].complete;
+        cnf_lower_bound = job->stats[TASK_CNF].lower_bound;
+        bnb_lower_bound = job->stats[TASK_BNB].lower_bound;
+        result_cnf.swap(job->covers[TASK_CNF]);
+        result_approx_1.swap(job->covers[TASK_APPROX_1]);
+        result_approx_2.swap(job->covers[TASK_APPROX_2]);
+        result_bnb.swap(job->covers[TASK_BNB]);
+        result_ls.swap(job->covers[TASK_LS]);
+        time_cnf_sat = job->times[TASK_CNF];
+        time_approx1 = job->times[TASK_APPROX_1];
+        time_approx2 = job->times[TASK_APPROX_2];
+        time_bnb = job->times[TASK_BNB];
+        time_ls = job->times[TASK_LS];
+        time_kernel = job->stats[TASK_CNF].kernel_time;
+        kernel_vertices = job->stats[TASK_CNF].kernel_vertices;
+        cache_lookup = job->lookup;
+        if (calc_mode)
+            Calc(job->v_count);
+        Printer();
+        cout.flush();
+    }
 
-            break;
+    void write()
+    {
+        pthread_mutex_lock(&this->lock);
+        while (true)
+        {
+            while (this->jobs.empty() && !this->closing)
+                pthread_cond_wait(&this->job_ready, &this->lock);
+            if (this->jobs.empty())
+                break;
+            BatchJob *job = this->jobs.front();
+            struct timespec wake = {0, 0};
+            if (!this->ready(job, &wake))
+            {
+                if (wake.tv_sec == 0)
+                    pthread_cond_wait(&this->job_ready, &this->lock);
+                else
+                    pthread_cond_timedwait(&this->job_ready, &this->lock, &wake);
+                continue;
+            }
+            this->jobs.pop_front();
+            pthread_cond_signal(&this->space);
+            pthread_mutex_unlock(&this->lock);
+
+            this->print(job);
+
+            pthread_mutex_lock(&this->lock);
+            job->printed = true;
+            this->release(job);
         }
-        default:
-            cout << "Error: invalid argument" << endl;
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    static void *worker(void *arg)
+    {
+        ((BatchPipeline *)arg)->work();
+        return NULL;
+    }
+
+    static void *writerMain(void *arg)
+    {
+        ((BatchPipeline *)arg)->write();
+        return NULL;
+    }
+
+    // looks the job's graph up in the cache, before it is queued and outside the lock
+    static void lookup(BatchJob *job)
+    {
+        if (cache == NULL || !job->hasVertex)
+            return;
+        TraceScope trace(&tracer, "cache", "io");
+        cache->key(&job->graph, job->key);
+        job->warm.clear();
+        job->warm_lower = 0;
+        bool found = cache->lookup(&job->graph, job->key, job->warm, job->warm_lower);
+        job->lookup = found && job->warm_lower >= job->warm.size() ? LOOKUP_HIT : LOOKUP_MISS;
+    }
+
+    // queues the job's tasks, under the lock
+    void enqueue(BatchJob *job)
+    {
+        if (!job->hasVertex)
+            return;
+        // the exact solvers go first so they start their clock as early as possible
+        int order[TASK_COUNT] = {TASK_CNF, TASK_BNB, TASK_APPROX_1, TASK_APPROX_2, TASK_LS};
+        for (int task : order)
+        {
+            job->control[task].reset(options, &job->graph);
+            if (!task_enabled(task))
+                continue;
+            bool exact = task == TASK_CNF || task == TASK_BNB;
+            if (exact && job->lookup == LOOKUP_HIT)
+            {
+                // a proven optimum from the cache stands in for the run
+                job->covers[task] = job->warm;
+                job->stats[task].lower_bound = job->warm_lower;
+                continue;
+            }
+            // only a cover that passed the check against the graph may warm-start a run
+            if (exact && job->lookup == LOOKUP_MISS && !job->warm.empty())
+                job->control[task].seed(job->warm, job->warm_lower);
+            job->queued[task] = true;
+            job->pending++;
+            this->tasks.push_back(make_pair(job, task));
         }
+        pthread_cond_broadcast(&this->task_ready);
     }
-    return NULL;
+
+public:
+    BatchPipeline(int threads)
+    {
+        // bounds the parsed graphs held in memory ahead of the slowest job
+        this->window = 4 * threads;
+        pthread_mutex_init(&this->lock, NULL);
+        pthread_cond_init(&this->task_ready, NULL);
+        pthread_cond_init(&this->job_ready, NULL);
+        pthread_cond_init(&this->space, NULL);
+        this->workers.resize(threads);
+        for (int i = 0; i < threads; i++)
+            pthread_create(&this->workers[i], NULL, &BatchPipeline::worker, this);
+        pthread_create(&this->writer, NULL, &BatchPipeline::writerMain, this);
+    }
+
+    ~BatchPipeline()
+    {
+        pthread_mutex_destroy(&this->lock);
+        pthread_cond_destroy(&this->task_ready);
+        pthread_cond_destroy(&this->job_ready);
+        pthread_cond_destroy(&this->space);
+    }
+
+    // Queues a job behind everything submitted before it; blocks while the window is full
+    void submit(BatchJob *job)
+    {
+        lookup(job);
+        pthread_mutex_lock(&this->lock);
+        while (this->jobs.size() >= this->window)
+            pthread_cond_wait(&this->space, &this->lock);
+        this->enqueue(job);
+        this->jobs.push_back(job);
+        pthread_cond_signal(&this->job_ready);
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    // Runs a job on the workers without the writer and waits until it is done, cancelling
+    // its exact solvers at their deadline. The caller prints and deletes the job.
+    void solve(BatchJob *job)
+    {
+        lookup(job);
+        pthread_mutex_lock(&this->lock);
+        this->enqueue(job);
+        while (true)
+        {
+            struct timespec wake = {0, 0};
+            if (this->ready(job, &wake))
+                break;
+            if (wake.tv_sec == 0)
+                pthread_cond_wait(&this->job_ready, &this->lock);
+            else
+                pthread_cond_timedwait(&this->job_ready, &this->lock, &wake);
+        }
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    // Drains the pipeline and stops the threads
+    void finish()
+    {
+        pthread_mutex_lock(&this->lock);
+        this->closing = true;
+        pthread_cond_broadcast(&this->task_ready);
+        pthread_cond_broadcast(&this->job_ready);
+        pthread_mutex_unlock(&this->lock);
+        pthread_join(this->writer, NULL);
+        for (pthread_t &worker : this->workers)
+            pthread_join(worker, NULL);
+    }
+};
+
+BatchPipeline *pipeline = NULL;
+
+// Prints an input error, or queues it behind the pending jobs in batch mode
+static void report(const string &message)
+{
+    if (pipeline == NULL)
+    {
+        cout << message << endl;
+        return;
+    }
+    BatchJob *job = new BatchJob();
+    job->message = message;
+    pipeline->submit(job);
 }
 
-// Main Program
-int main(int argc, char *argv[])
+// Hands a copy of the current graph to the pipeline
+static void submit_graph(bool hasVertex)
 {
-    if (argc == 2)
-        if (strcmp(argv[1], "-calc") == 0)
-            calc_mode = true;
+    BatchJob *job = new BatchJob();
+    job->v_count = v_Count;
+    job->solve = true;
+    job->hasVertex = hasVertex;
+    if (hasVertex)
+    {
+        job->graph = *graph;
+        if (options.approx2 == APPROX2_MATCHING)
+            job->edges = edge_list;
+        job->components.swap(components);
+    }
+    pipeline->submit(job);
+}
 
-    pthread_t _io;
-    pthread_create(&_io, NULL, &I_O, NULL);
-    pthread_join(_io, NULL);
-    if (calc_mode)
+// Runs every solver on the current graph and prints the covers
+static void solve_graph(bool hasVertex)
+{
+    if (pipeline != NULL)
+    {
+        submit_graph(hasVertex);
+        return;
+    }
+    hasTimedOut = false;
+    bnbTimedOut = false;
+    cache_lookup = LOOKUP_NONE;
+    if (hasVertex)
     {
-        for (CalcStorage *item : calc_data)
+        cnf_control.reset(options, graph);
+        bnb_control.reset(options, graph);
+        // the exact solvers restart from the best cover known, and no cover is below lower
+        vector<int> warm;
+        uint32_t lower = 0;
+        if (graph_edit.active)
+        {
+            // the better previous cover, repaired: opt - decrease <= opt' <= |cover|
+            vector<int> other = result_bnb;
+            warm = result_cnf;
+            repair_cover(graph, graph_edit, false, warm);
+            if (bnb_mode)
+            {
+                repair_cover(graph, graph_edit, false, other);
+                if (other.size() < warm.size())
+                    warm.swap(other);
+            }
+            lower = std::max(cnf_lower_bound, bnb_mode ? bnb_lower_bound : 0);
+            lower = lower > graph_edit.decrease ? lower - graph_edit.decrease : 0;
+        }
+        CacheKey key;
+        if (cache != NULL)
+        {
+            TraceScope trace(&tracer, "cache", "io");
+            vector<int> cached;
+            uint32_t cached_lower = 0;
+            cache->key(graph, key);
+            bool found = cache->lookup(graph, key, cached, cached_lower);
+            if (found && (warm.empty() || cached.size() < warm.size()))
+                warm.swap(cached);
+            if (found)
+                lower = std::max(lower, cached_lower);
+            cache_lookup = found && lower >= warm.size() ? LOOKUP_HIT : LOOKUP_MISS;
+        }
+        // a proven optimum from the cache answers both exact solvers
+        bool exact = cache_lookup != LOOKUP_HIT;
+        if (!exact)
+        {
+            result_cnf = warm;
+            result_bnb = warm;
+            cnf_lower_bound = lower;
+            bnb_lower_bound = lower;
+        }
+        else if (!warm.empty())
+        {
+            cnf_control.seed(warm, lower);
+            bnb_control.seed(warm, lower);
+        }
+        if (exact)
+            pthread_create(&cnf_sat_vc, NULL, &CNF_SAT_VC, NULL);
+        pthread_create(&approx_vc_1, NULL, &APPROX_VC_1, NULL);
+        pthread_create(&approx_vc_2, NULL, &APPROX_VC_2, NULL);
+        if (exact && bnb_mode)
+            pthread_create(&bnb_vc, NULL, &BNB_VC, NULL);
+        if (options.ls_time > 0)
+            pthread_create(&ls_vc, NULL, &LS_VC, NULL);
+
+        struct timespec ts;
+        if (!budget_deadline(options.time_budget, ts))
+            handle_error("CLOCK_REALTIME");
+        // past the deadline the solvers are cancelled and return their best cover so far
+        if (exact && pthread_timedjoin_np(cnf_sat_vc, NULL, &ts) != 0)
         {
-            item->calc();
+            cnf_control.cancel();
+            pthread_join(cnf_sat_vc, NULL);
         }
-        cout << "=================== Calc Mode Start ===================" << endl;
-        cout << "========= Ratio =========" << endl;
-        for (CalcStorage *item : calc_data)
+        if (exact && bnb_mode && pthread_timedjoin_np(bnb_vc, NULL, &ts) != 0)
         {
-            cout << item->Ratio_toString() << endl;
-            cout << "---------------" << endl;
+            bnb_control.cancel();
+            pthread_join(bnb_vc, NULL);
         }
-        cout << "========= Runtime =========" << endl;
-        for (CalcStorage *item : calc_data)
+        pthread_join(approx_vc_1, NULL);
+        pthread_join(approx_vc_2, NULL);
+        if (options.ls_time > 0)
+            pthread_join(ls_vc, NULL);
+        if (cache_lookup == LOOKUP_MISS)
         {
-            cout << item->Runtime_toString() << endl;
-            cout << "---------------" << endl;
+            // the smaller exact cover and the larger proven bound
+            bool bnb_better = bnb_mode && result_bnb.size() < result_cnf.size();
+            cache->store(key, bnb_better ? result_bnb : result_cnf, std::max(cnf_lower_bound, bnb_mode ? bnb_lower_bound : 0));
         }
-        cout << "=================== Calc Mode End ===================" << endl;
     }
+    else
+    {
+        result_cnf.clear();
+        result_approx_1.clear();
+        result_approx_2.clear();
+        result_bnb.clear();
+        result_ls.clear();
+        cnf_lower_bound = 0;
+        bnb_lower_bound = 0;
+    }
+    if (calc_mode)
+        Calc(v_Count);
+
+    Printer();
+    has_solution = true;
+    graph_edit.active = false;
+}
+
+// Loads one -input file into the current graph and solves it
+static void load_input(const string &path)
+{
+    FileFormat format = input_format == FORMAT_AUTO ? detect_format(path) : input_format;
+    string error;
+    uint32_t count = 0;
+    bool loaded;
+    edge_list.clear();
+    {
+        TraceScope trace(&tracer, "parse", "io");
+        if (format == FORMAT_BINARY)
+        {
+            loaded = graph->attach(path, error);
+            count = graph->vertexCount();
+        }
+        else if (format == FORMAT_METIS || format == FORMAT_DIMACS)
+            loaded = load_text_graph(path, format, count, edge_list, error);
+        else
+        {
+            loaded = false;
+            error = "Error: unknown format for " + path + ", use -format";
+        }
+        trace.arg("edges", edge_list.size());
+    }
+    if (!loaded)
+    {
+        report(error);
+        return;
+    }
+
+    v_Count = count;
+    if (format != FORMAT_BINARY)
+    {
+        TraceScope trace(&tracer, "build", "io");
+        graph->build(v_Count, edge_list);
+        trace.arg("vertices", v_Count);
+    }
+    if (!save_path.empty() && !graph->save(save_path))
+        report("Error: cannot write " + save_path);
+    if (options.component_threads > 0)
+        split_components(graph, components);
+    solve_graph(graph->edgeCount() > 0);
+}
+
+// Applies an incremental command to the current graph and solves it again: 'A' adds and
+// 'R' removes the listed edges, 'N k' appends k isolated vertices and 'X v' removes the
+// edges of vertex v. Outside batch mode the solvers repair their previous covers.
+static void edit_graph(char cmd, const string &line, size_t pos)
+{
+    GraphEdit edit;
+    {
+        TraceScope trace(&tracer, "edit", "io");
+        if (cmd == 'N' || cmd == 'X')
+        {
+            char *end;
+            long value = strtol(line.c_str() + pos, &end, 10);
+            bool valid = end != line.c_str() + pos && value >= 0 && (cmd == 'N' ? value <= INT32_MAX - v_Count : value < v_Count);
+            if (!valid)
+            {
+                report(cmd == 'N' ? "Error: invalid vertex count" : "Error: vertex id out of range");
+                return;
+            }
+            if (cmd == 'N')
+                v_Count += value;
+            else
+            {
+                // v first: once isolated it leaves the cover, and its neighbours may follow
+                uint32_t v = value;
+                edit.touched.push_back(v);
+                graph->neighbours(v, edit.touched);
+                edit.decrease = graph->degree(v) > 0 ? 1 : 0;
+                edge_list.erase(std::remove_if(edge_list.begin(), edge_list.end(), [v](const Edge &e) {
+                                    return e.first == v || e.second == v;
+                                }),
+                                edge_list.end());
+            }
+        }
+        else
+        {
+            vector<Edge> edges;
+            string error;
+            if (!parser(line, pos, v_Count, edges, error))
+                report(error);
+            if (cmd == 'A')
+            {
+                edge_list.insert(edge_list.end(), edges.begin(), edges.end());
+                edit.added.swap(edges);
+            }
+            else
+            {
+                for (Edge &e : edges)
+                {
+                    if (e.first > e.second)
+                        std::swap(e.first, e.second);
+                }
+                sort(edges.begin(), edges.end());
+                edges.erase(unique(edges.begin(), edges.end()), edges.end());
+                vector<bool> found(edges.size(), false);
+                edge_list.erase(std::remove_if(edge_list.begin(), edge_list.end(), [&edges, &found](const Edge &e) {
+                                    Edge key(std::min(e.first, e.second), std::max(e.first, e.second));
+                                    vector<Edge>::iterator it = lower_bound(edges.begin(), edges.end(), key);
+                                    if (it == edges.end() || *it != key)
+                                        return false;
+                                    found[it - edges.begin()] = true;
+                                    return true;
+                                }),
+                                edge_list.end());
+                for (size_t i = 0; i < edges.size(); i++)
+                {
+                    if (!found[i])
+                    {
+                        report("Error: no edge <" + to_string(edges[i].first) + "," + to_string(edges[i].second) + ">");
+                        continue;
+                    }
+                    edit.touched.push_back(edges[i].first);
+                    edit.touched.push_back(edges[i].second);
+                    edit.decrease++;
+                }
+            }
+        }
+    }
+    {
+        TraceScope trace(&tracer, "build", "io");
+        graph->build(v_Count, edge_list);
+        trace.arg("vertices", v_Count);
+    }
+    if (options.component_threads > 0)
+        split_components(graph, components);
+    edit.active = has_solution && pipeline == NULL;
+    graph_edit = edit;
+    solve_graph(graph->edgeCount() > 0);
+}
+
+// ------------------------ Stream Mode ------------------------ //
+// With -stream the graph is never stored: edges are parsed out of a fixed read buffer and
+// fed to a StreamCover, so memory is O(V) however long the 'E' line or the file is. -prune
+// reads the same edges a second time, which needs a file or seekable standard input.
+
+// Every edge of a mapped binary CSR once, from its lower endpoint; the kernel pages the
+// file in and out as the pass moves through it
+template <class G>
+static void stream_csr(const G *graph, StreamCover &cover)
+{
+    for (uint32_t u = 0; u < graph->vertexCount(); u++)
+    {
+        for (const typename G::Id *it = graph->begin(u); it != graph->end(u); ++it)
+        {
+            if (u < *it)
+                cover.edge(u, *it);
+        }
+    }
+}
+
+// Writes "STREAM-VC: a,b,..." in id order straight to the output, never holding the cover
+static void print_stream_cover(const StreamCover &cover, uint32_t v_count)
+{
+    TraceScope trace(&tracer, "print", "io");
+    cout << "STREAM-VC:";
+    char separator = ' ';
+    for (uint32_t v = 0; v < v_count; v++)
+    {
+        if (cover.contains(v))
+        {
+            cout << separator << v;
+            separator = ',';
+        }
+    }
+    cout << "\n";
+}
+
+// The second pass over what mark starts; false when the input cannot be read again
+static bool stream_prune_pass(StreamCover &cover, const string &name, const string &path, StreamReader &in, const StreamReader::Mark &mark, uint32_t v_count, FileFormat format)
+{
+    TraceScope trace(&tracer, "prune", "stream");
+    cover.prune();
+    string error;
+    if (!in.seek(mark))
+    {
+        report("Error: cannot read " + name + " again for -prune");
+        return false;
+    }
+    uint32_t count = v_count;
+    // the cover is sized already, so the header needs no handling this time
+    auto header = [](uint64_t, uint64_t) {};
+    auto edge = [&](uint32_t u, uint32_t v) { cover.edge(u, v); };
+    if (format == FORMAT_DIMACS)
+        read_dimacs(in, path, count, header, edge, error);
+    else if (format == FORMAT_METIS)
+        read_metis(in, path, count, header, edge, error);
+    else
+        read_edges(in, v_count, edge, error);
+    if (count != v_count || cover.missedEdges() > 0)
+    {
+        report("Error: " + name + " changed between the passes of -prune");
+        return false;
+    }
+    return true;
+}
+
+// Streams one -input file: DIMACS, METIS or binary CSR
+static void stream_input(const string &path)
+{
+    FileFormat format = input_format == FORMAT_AUTO ? detect_format(path) : input_format;
+    StreamCover cover;
+    uint32_t v_count = 0;
+    string error;
+    if (format == FORMAT_BINARY)
+    {
+        // mapped rather than read, so both passes are sequential walks over the page cache
+        Graph mapped;
+        if (!mapped.attach(path, error))
+        {
+            report(error);
+            return;
+        }
+        v_count = mapped.vertexCount();
+        cover.reset(v_count, stream_prune);
+        {
+            TraceScope trace(&tracer, "STREAM-VC", "solver");
+            CSR_DISPATCH(&mapped, view, stream_csr(view, cover));
+        }
+        if (stream_prune)
+        {
+            TraceScope trace(&tracer, "prune", "solver");
+            cover.prune();
+            CSR_DISPATCH(&mapped, view, stream_csr(view, cover));
+        }
+        print_stream_cover(cover, v_count);
+        return;
+    }
+    if (format != FORMAT_DIMACS && format != FORMAT_METIS)
+    {
+        report("Error: unknown format for " + path + ", use -format");
+        return;
+    }
+
+    StreamReader in;
+    if (!in.open(path))
+    {
+        report("Error: cannot open " + path);
+        return;
+    }
+    StreamReader::Mark start = in.mark();
+    bool loaded;
+    {
+        TraceScope trace(&tracer, "STREAM-VC", "solver");
+        auto header = [&](uint64_t n, uint64_t) { cover.reset(n, stream_prune); };
+        auto edge = [&](uint32_t u, uint32_t v) { cover.edge(u, v); };
+        if (format == FORMAT_DIMACS)
+            loaded = read_dimacs(in, path, v_count, header, edge, error);
+        else
+            loaded = read_metis(in, path, v_count, header, edge, error);
+    }
+    if (!loaded)
+    {
+        report(error);
+        return;
+    }
+    if (stream_prune && !stream_prune_pass(cover, path, path, in, start, v_count, format))
+        return;
+    print_stream_cover(cover, v_count);
+}
+
+// The stdin protocol without edits: every 'E' prints the cover of its edges as soon as its
+// line has been read
+static void stream_stdin()
+{
+    StreamReader in;
+    in.attach(STDIN_FILENO);
+    StreamCover cover;
+    uint32_t v_count = 0;
+    string error;
+    while (true)
+    {
+        // a blank line ends the input
+        skip_blanks(in);
+        if (in.peek() == EOF || in.peek() == '\n')
+            break;
+        int cmd = in.get();
+        if (cmd == 'V')
+        {
+            uint64_t count;
+            skip_blanks(in);
+            if (!read_number(in, count) || count > INT32_MAX)
+            {
+                report("Error: invalid vertex count");
+                count = 0;
+            }
+            v_count = count;
+        }
+        else if (cmd == 'E')
+        {
+            StreamReader::Mark start = in.mark();
+            cover.reset(v_count, stream_prune);
+            bool parsed;
+            {
+                TraceScope trace(&tracer, "STREAM-VC", "solver");
+                parsed = read_edges(in, v_count, [&](uint32_t u, uint32_t v) { cover.edge(u, v); }, error);
+            }
+            if (!parsed)
+                report(error);
+            if (stream_prune)
+            {
+                // the second pass reads the line again, then carries on after it
+                StreamReader::Mark end = in.mark();
+                if (!stream_prune_pass(cover, "standard input", "", in, start, v_count, FORMAT_AUTO) || !in.seek(end))
+                    return;
+            }
+            print_stream_cover(cover, v_count);
+        }
+        else if (cmd == 'A' || cmd == 'R' || cmd == 'N' || cmd == 'X')
+            report("Error: edits need the stored graph and are not available with -stream");
+        else
+            report("Error: invalid argument");
+        skip_line(in);
+    }
+}
+
+// ------------------------ IO Thread ------------------------ //
+void *I_O(void *arg)
+{
+    char cmd;
+    // reused across lines so steady-state reads do not allocate
+    string line, error;
+    while (!cin.eof())
+    {
+        getline(cin, line);
+
+        // a blank line ends the input
+        size_t pos = 0;
+        while (pos < line.size() && isspace((unsigned char)line[pos]))
+            pos++;
+        if (pos == line.size())
+            break;
+        cmd = line[pos++];
+
+        switch (cmd)
+        {
+        case 'V':
+        {
+            char *end;
+            long count = strtol(line.c_str() + pos, &end, 10);
+            if (end == line.c_str() + pos || count < 0 || count > INT32_MAX)
+            {
+                report("Error: invalid vertex count");
+                count = 0;
+            }
+            v_Count = count;
+            graph->clear();
+            edge_list.clear();
+            has_solution = false;
+            break;
+        }
+        case 'E':
+        {
+            size_t before = edge_list.size();
+            {
+                TraceScope trace(&tracer, "parse", "io");
+                if (!parser(line, pos, v_Count, edge_list, error))
+                    report(error);
+                trace.arg("edges", edge_list.size() - before);
+            }
+            bool hasVertex = edge_list.size() > before;
+            {
+                TraceScope trace(&tracer, "build", "io");
+                graph->build(v_Count, edge_list);
+                trace.arg("vertices", v_Count);
+            }
+            if (options.component_threads > 0)
+                split_components(graph, components);
+
+            solve_graph(hasVertex);
+
+            break;
+        }
+        case 'A':
+        case 'R':
+        case 'N':
+        case 'X':
+            edit_graph(cmd, line, pos);
+            break;
+        default:
+            report("Error: invalid argument");
+        }
+    }
+    return NULL;
+}
+
+// ------------------------ Server ------------------------ //
+// With -serve PATH the program stays up and listens on a Unix domain socket instead of
+// reading stdin. Every client gets a thread that parses its requests and hands each graph
+// to one shared BatchPipeline, whose workers run the solvers; the client's thread waits for
+// its job and writes the covers back in request order. A request is either a line of the
+// stdin protocol (V, E, and "T s" to give the following graphs s seconds of exact solving)
+// or a binary frame, in host byte order like the VCSR files:
+//   request:  "VCRQ", uint32 vertex count, uint32 edge count, uint32 budget in milliseconds
+//             (0 for -timeout), then edge count pairs of uint32 vertex ids
+//   response: "VCRS", uint32 length, then the text the line protocol prints for the graph
+
+// ServerClient Class
+// One connection: its own V/E state and a read buffer that can tell frames from lines
+class ServerClient
+{
+private:
+    int fd;
+    BatchPipeline *pool;
+    string buffer;
+    size_t head = 0;
+    bool closed = false;
+    int v_count = 0;
+    vector<Edge> edges;
+    double budget = 0;
+
+    // reads more input into the buffer; false at end of stream
+    bool fill()
+    {
+        if (this->closed)
+            return false;
+        if (this->head > 0 && this->head == this->buffer.size())
+        {
+            this->buffer.clear();
+            this->head = 0;
+        }
+        char chunk[65536];
+        ssize_t got;
+        do
+            got = read(this->fd, chunk, sizeof(chunk));
+        while (got < 0 && errno == EINTR);
+        if (got <= 0)
+        {
+            this->closed = true;
+            return false;
+        }
+        this->buffer.append(chunk, got);
+        return true;
+    }
+
+    size_t available()
+    {
+        return this->buffer.size() - this->head;
+    }
+
+    bool readBytes(void *out, size_t n)
+    {
+        while (this->available() < n)
+        {
+            if (!this->fill())
+                return false;
+        }
+        memcpy(out, this->buffer.data() + this->head, n);
+        this->head += n;
+        return true;
+    }
+
+    bool readLine(string &line)
+    {
+        size_t end;
+        while ((end = this->buffer.find('\n', this->head)) == string::npos)
+        {
+            if (!this->fill())
+            {
+                // a last line without a newline still counts
+                if (this->available() == 0)
+                    return false;
+                end = this->buffer.size();
+                break;
+            }
+        }
+        line.assign(this->buffer, this->head, end - this->head);
+        this->head = std::min(end + 1, this->buffer.size());
+        return true;
+    }
+
+    // a frame starts with its magic; any line shorter than that ends with a newline
+    bool atFrame()
+    {
+        while (this->available() < 4 && this->buffer.find('\n', this->head) == string::npos)
+        {
+            if (!this->fill())
+                break;
+        }
+        return this->available() >= 4 && memcmp(this->buffer.data() + this->head, "VCRQ", 4) == 0;
+    }
+
+    bool send(const string &data)
+    {
+        size_t sent = 0;
+        while (sent < data.size())
+        {
+            ssize_t n = ::send(this->fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    // Solves the graph on the shared workers and returns the output lines
+    string solve(uint32_t count, const vector<Edge> &edges, bool hasVertex, double budget)
+    {
+        BatchJob *job = new BatchJob();
+        job->v_count = count;
+        job->solve = true;
+        job->hasVertex = hasVertex;
+        job->budget = budget;
+        if (hasVertex)
+        {
+            job->graph.build(count, edges);
+            if (options.approx2 == APPROX2_MATCHING)
+                job->edges = edges;
+            if (options.component_threads > 0)
+                split_components(&job->graph, job->components);
+        }
+        this->pool->solve(job);
+        string output = job_toString(job);
+        delete job;
+        return output;
+    }
+
+    bool serveLine(const string &line)
+    {
+        size_t pos = 0;
+        while (pos < line.size() && isspace((unsigned char)line[pos]))
+            pos++;
+        if (pos == line.size())
+            return true;
+        char cmd = line[pos++];
+        string output, error;
+        if (cmd == 'V')
+        {
+            char *end;
+            long count = strtol(line.c_str() + pos, &end, 10);
+            if (end == line.c_str() + pos || count < 0 || count > INT32_MAX)
+            {
+                output = "Error: invalid vertex count\n";
+                count = 0;
+            }
+            this->v_count = count;
+            this->edges.clear();
+        }
+        else if (cmd == 'E')
+        {
+            size_t before = this->edges.size();
+            if (!parser(line, pos, this->v_count, this->edges, error))
+                output = error + "\n";
+            output += this->solve(this->v_count, this->edges, this->edges.size() > before, this->budget);
+        }
+        else if (cmd == 'T')
+        {
+            char *end;
+            double seconds = strtod(line.c_str() + pos, &end);
+            if (end == line.c_str() + pos || seconds <= 0)
+                output = "Error: invalid time budget\n";
+            else
+                this->budget = seconds;
+        }
+        else
+            output = "Error: invalid argument\n";
+        return output.empty() || this->send(output);
+    }
+
+    bool serveFrame()
+    {
+        uint32_t header[4];
+        if (!this->readBytes(header, sizeof(header)))
+            return false;
+        uint32_t count = header[1], m = header[2];
+        // more edges than a simple graph on count vertices has would only make us allocate
+        // what the client claims, so such a frame ends the connection like a bad count
+        if (count > INT32_MAX || m > (uint64_t)count * (count - (count > 0)) / 2)
+            return false;
+        vector<Edge> edges;
+        for (uint32_t i = 0; i < m; i++)
+        {
+            uint32_t pair[2];
+            if (!this->readBytes(pair, sizeof(pair)))
+                return false;
+            edges.push_back(Edge(pair[0], pair[1]));
+        }
+        string output;
+        for (const Edge &e : edges)
+        {
+            if (e.first >= count || e.second >= count || e.first == e.second)
+            {
+                output = "Error: invalid edge <" + to_string(e.first) + "," + to_string(e.second) + ">\n";
+                break;
+            }
+        }
+        if (output.empty())
+            output = this->solve(count, edges, m > 0, header[3] / 1000.0);
+        uint32_t length = output.size();
+        string frame("VCRS", 4);
+        frame.append((const char *)&length, sizeof(length));
+        return this->send(frame + output);
+    }
+
+public:
+    ServerClient(int fd, BatchPipeline *pool) : fd(fd), pool(pool) {}
+
+    // serves requests until the client hangs up or sends something unreadable
+    void run()
+    {
+        string line;
+        while (true)
+        {
+            if (this->atFrame())
+            {
+                if (!this->serveFrame())
+                    break;
+            }
+            else if (!this->readLine(line) || !this->serveLine(line))
+                break;
+        }
+    }
+};
+
+// SolveServer Class
+// Accepts clients until SIGINT or SIGTERM, then stops reading from the connected ones, lets
+// their current requests finish and removes the socket.
+class SolveServer
+{
+private:
+    string path;
+    int listener = -1;
+    BatchPipeline pool;
+    pthread_mutex_t lock;
+    pthread_cond_t idle;
+    vector<int> clients;
+
+    static int stop_fd;
+
+    static void stop(int sig)
+    {
+        // accept() then fails and the loop ends; shutdown is async-signal-safe
+        shutdown(stop_fd, SHUT_RDWR);
+    }
+
+    struct ClientArg
+    {
+        SolveServer *server;
+        int fd;
+    };
+
+    static void *clientMain(void *arg)
+    {
+        ClientArg *c = (ClientArg *)arg;
+        {
+            TraceScope trace(&tracer, "client", "server");
+            ServerClient client(c->fd, &c->server->pool);
+            client.run();
+        }
+        c->server->leave(c->fd);
+        delete c;
+        return NULL;
+    }
+
+    void leave(int fd)
+    {
+        pthread_mutex_lock(&this->lock);
+        this->clients.erase(std::find(this->clients.begin(), this->clients.end(), fd));
+        close(fd);
+        pthread_cond_signal(&this->idle);
+        pthread_mutex_unlock(&this->lock);
+    }
+
+public:
+    SolveServer(const string &path, int threads) : path(path), pool(threads)
+    {
+        pthread_mutex_init(&this->lock, NULL);
+        pthread_cond_init(&this->idle, NULL);
+    }
+
+    ~SolveServer()
+    {
+        this->pool.finish();
+        pthread_mutex_destroy(&this->lock);
+        pthread_cond_destroy(&this->idle);
+    }
+
+    // Binds the socket, replacing a stale one; false when that fails
+    bool listen()
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (this->path.size() >= sizeof(addr.sun_path))
+            return false;
+        strcpy(addr.sun_path, this->path.c_str());
+        this->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (this->listener < 0)
+            return false;
+        unlink(this->path.c_str());
+        return bind(this->listener, (struct sockaddr *)&addr, sizeof(addr)) == 0 && ::listen(this->listener, SOMAXCONN) == 0;
+    }
+
+    void run()
+    {
+        stop_fd = this->listener;
+        signal(SIGINT, &SolveServer::stop);
+        signal(SIGTERM, &SolveServer::stop);
+        while (true)
+        {
+            int fd = accept(this->listener, NULL, NULL);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                break;
+            }
+            ClientArg *c = new ClientArg();
+            c->server = this;
+            c->fd = fd;
+            pthread_mutex_lock(&this->lock);
+            this->clients.push_back(fd);
+            pthread_mutex_unlock(&this->lock);
+            pthread_t thread;
+            pthread_create(&thread, NULL, &SolveServer::clientMain, c);
+            pthread_detach(thread);
+        }
+
+        // clients see the end of their input after the request they are in
+        pthread_mutex_lock(&this->lock);
+        for (int fd : this->clients)
+            shutdown(fd, SHUT_RD);
+        while (!this->clients.empty())
+            pthread_cond_wait(&this->idle, &this->lock);
+        pthread_mutex_unlock(&this->lock);
+        close(this->listener);
+        unlink(this->path.c_str());
+    }
+};
+
+int SolveServer::stop_fd = -1;
+
+// Main Program
+int main(int argc, char *argv[])
+{
+    std::ios::sync_with_stdio(false);
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-calc") == 0)
+            calc_mode = true;
+        else if (strcmp(argv[i], "-calcformat") == 0 && i + 1 < argc)
+        {
+            string format = argv[++i];
+            if (format == "text")
+                calc_format = CALC_TEXT;
+            else if (format == "csv")
+                calc_format = CALC_CSV;
+            else if (format == "json")
+                calc_format = CALC_JSON;
+            else
+            {
+                cerr << "Error: unknown calc format " << format << endl;
+                return EXIT_FAILURE;
+            }
+            calc_mode = true;
+        }
+        else if (strcmp(argv[i], "-bnb") == 0)
+            bnb_mode = true;
+        else if (int parsed = vc::parse_solver_option(argc, argv, i, options))
+        {
+            if (parsed < 0)
+                return EXIT_FAILURE;
+        }
+        else if (strcmp(argv[i], "-batch") == 0 && i + 1 < argc)
+        {
+            batch_threads = atoi(argv[++i]);
+            if (batch_threads < 1)
+            {
+                cerr << "Error: -batch needs a positive worker count" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "-cache") == 0 && i + 1 < argc)
+        {
+            long size = atol(argv[++i]);
+            if (size < 1)
+            {
+                cerr << "Error: -cache needs a positive entry count" << endl;
+                return EXIT_FAILURE;
+            }
+            cache_size = size;
+        }
+        else if (strcmp(argv[i], "-cachemode") == 0 && i + 1 < argc)
+        {
+            string mode = argv[++i];
+            if (mode == "exact")
+                cache_mode = CACHE_EXACT;
+            else if (mode == "wl")
+                cache_mode = CACHE_WL;
+            else
+            {
+                cerr << "Error: unknown cache mode " << mode << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "-cachefile") == 0 && i + 1 < argc)
+            cache_path = argv[++i];
+        else if (strcmp(argv[i], "-stream") == 0)
+            stream_mode = true;
+        else if (strcmp(argv[i], "-prune") == 0)
+        {
+            stream_mode = true;
+            stream_prune = true;
+        }
+        else if (strcmp(argv[i], "-serve") == 0 && i + 1 < argc)
+            serve_path = argv[++i];
+        else if (strcmp(argv[i], "-input") == 0 && i + 1 < argc)
+            input_files.push_back(argv[++i]);
+        else if (strcmp(argv[i], "-save") == 0 && i + 1 < argc)
+            save_path = argv[++i];
+        else if (strcmp(argv[i], "-trace") == 0 && i + 1 < argc)
+            trace_path = argv[++i];
+        else if (strcmp(argv[i], "-perf") == 0)
+            perf_mode = true;
+        else if (strcmp(argv[i], "-format") == 0 && i + 1 < argc)
+        {
+            string format = argv[++i];
+            if (format == "dimacs")
+                input_format = FORMAT_DIMACS;
+            else if (format == "metis")
+                input_format = FORMAT_METIS;
+            else if (format == "binary")
+                input_format = FORMAT_BINARY;
+            else
+            {
+                cerr << "Error: unknown input format " << format << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            cerr << "Error: unknown option " << argv[i] << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!save_path.empty() && input_files.size() != 1)
+    {
+        cerr << "Error: -save needs exactly one -input file" << endl;
+        return EXIT_FAILURE;
+    }
+    if (!serve_path.empty() && (calc_mode || !input_files.empty()))
+    {
+        cerr << "Error: -serve takes its graphs from clients and cannot be combined with -input or -calc" << endl;
+        return EXIT_FAILURE;
+    }
+    if (perf_mode && trace_path.empty())
+    {
+        cerr << "Error: -perf needs -trace" << endl;
+        return EXIT_FAILURE;
+    }
+    if (stream_mode && (!serve_path.empty() || batch_threads > 0 || calc_mode || !save_path.empty() || cache_size > 0))
+    {
+        cerr << "Error: -stream cannot be combined with -serve, -batch, -calc, -save or -cache" << endl;
+        return EXIT_FAILURE;
+    }
+    if (stream_prune && input_files.empty() && lseek(STDIN_FILENO, 0, SEEK_CUR) < 0)
+    {
+        cerr << "Error: -prune reads the input twice and needs -input or a file as standard input" << endl;
+        return EXIT_FAILURE;
+    }
+    if (!cache_path.empty() && cache_size == 0)
+    {
+        cerr << "Error: -cachefile needs -cache" << endl;
+        return EXIT_FAILURE;
+    }
+    if (cache_size > 0)
+    {
+        cache = new ResultCache(cache_size, cache_mode);
+        string error;
+        if (!cache_path.empty() && !cache->load(cache_path, error))
+        {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!trace_path.empty())
+    {
+        tracer.start(perf_mode);
+        options.tracer = &tracer;
+    }
+
+    if (batch_threads > 0 && serve_path.empty())
+    {
+        // cin flushes its tied cout before every read, which would race with the writer thread
+        cin.tie(NULL);
+        pipeline = new BatchPipeline(batch_threads);
+    }
+    if (!serve_path.empty())
+    {
+        // -batch sizes the server's worker pool, one worker per CPU by default
+        int threads = batch_threads > 0 ? batch_threads : std::max<long>(1, sysconf(_SC_NPROCESSORS_ONLN));
+        SolveServer server(serve_path, threads);
+        if (!server.listen())
+        {
+            cerr << "Error: cannot listen on " << serve_path << endl;
+            return EXIT_FAILURE;
+        }
+        server.run();
+    }
+    else if (stream_mode && input_files.empty())
+        stream_stdin();
+    else if (stream_mode)
+    {
+        for (const string &path : input_files)
+            stream_input(path);
+    }
+    else if (input_files.empty())
+    {
+        pthread_t _io;
+        pthread_create(&_io, NULL, &I_O, NULL);
+        pthread_join(_io, NULL);
+    }
+    else
+    {
+        for (const string &path : input_files)
+            load_input(path);
+    }
+    if (pipeline != NULL)
+    {
+        pipeline->finish();
+        delete pipeline;
+    }
+    if (cache != NULL && !cache_path.empty() && !cache->save(cache_path))
+        cerr << "Error: cannot write " << cache_path << endl;
+    if (calc_mode)
+        print_calc();
+    if (!trace_path.empty() && !tracer.write(trace_path))
+        cerr << "Error: cannot write " << trace_path << endl;
 
     delete graph;
-    delete graph_approx_1;
-    delete graph_approx_2;
     return 0;
 }
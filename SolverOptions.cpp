@@ -0,0 +1,118 @@
+// SolverOptions.cpp
+// Command line parsing of SolverOptions, shared by prjece650 and prjece650-bench. It sits in
+// its own translation unit so that linking it does not pull in the solvers.
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <stdlib.h>
+
+#include "VertexCover.h"
+
+using namespace std;
+
+namespace vc
+{
+
+int parse_solver_option(int argc, char *argv[], int &i, SolverOptions &options)
+{
+    if (strcmp(argv[i], "-approx2") == 0 && i + 1 < argc)
+    {
+        string mode = argv[++i];
+        if (mode == "degree")
+            options.approx2 = APPROX2_DEGREE;
+        else if (mode == "matching")
+            options.approx2 = APPROX2_MATCHING;
+        else
+        {
+            cerr << "Error: unknown APPROX-VC-2 mode " << mode << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-kernel") == 0)
+        options.kernel = true;
+    else if (strcmp(argv[i], "-ls") == 0 && i + 1 < argc)
+    {
+        options.ls_time = atof(argv[++i]);
+        if (options.ls_time <= 0)
+        {
+            cerr << "Error: -ls needs a positive number of seconds" << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-bounds") == 0)
+        options.bounds = true;
+    else if (strcmp(argv[i], "-portfolio") == 0 && i + 1 < argc)
+    {
+        options.portfolio = atoi(argv[++i]);
+        if (options.portfolio < 1)
+        {
+            cerr << "Error: -portfolio needs a positive solver count" << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-components") == 0 && i + 1 < argc)
+    {
+        options.component_threads = atoi(argv[++i]);
+        if (options.component_threads < 1)
+        {
+            cerr << "Error: -components needs a positive thread count" << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-dense") == 0 && i + 1 < argc)
+    {
+        string value = argv[++i];
+        char *end;
+        options.dense_threshold = value == "off" ? 0 : strtod(value.c_str(), &end);
+        if (value != "off" && (*end != '\0' || options.dense_threshold <= 0 || options.dense_threshold > 1))
+        {
+            cerr << "Error: -dense needs a density in (0, 1] or off" << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-probes") == 0 && i + 1 < argc)
+    {
+        options.probe_threads = atoi(argv[++i]);
+        if (options.probe_threads < 1)
+        {
+            cerr << "Error: -probes needs a positive thread count" << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-encoding") == 0 && i + 1 < argc)
+    {
+        string mode = argv[++i];
+        if (mode == "pairwise")
+            options.encoding = ENCODING_PAIRWISE;
+        else if (mode == "counter")
+            options.encoding = ENCODING_COUNTER;
+        else
+        {
+            cerr << "Error: unknown CNF-SAT-VC encoding " << mode << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-timeout") == 0 && i + 1 < argc)
+    {
+        options.time_budget = atof(argv[++i]);
+        if (options.time_budget <= 0)
+        {
+            cerr << "Error: -timeout needs a positive number of seconds" << endl;
+            return -1;
+        }
+    }
+    else if (strcmp(argv[i], "-conflicts") == 0 && i + 1 < argc)
+    {
+        options.conflict_budget = atoll(argv[++i]);
+        if (options.conflict_budget < 1)
+        {
+            cerr << "Error: -conflicts needs a positive conflict count" << endl;
+            return -1;
+        }
+    }
+    else
+        return 0;
+    return 1;
+}
+
+} // namespace vc
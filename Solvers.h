@@ -0,0 +1,3259 @@
+// Solvers.h
+// Graph storage, tracing, kernelization and every vertex cover algorithm, shared by the
+// prjece650 executable and the vertexcover library. Nothing here touches process state:
+// solver tuning and the tracer arrive as SolverOptions, through SolveControl on the exact
+// path. Only classes, templates and static functions live here, so translation units that
+// include it link together.
+#ifndef SOLVERS_H
+#define SOLVERS_H
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// Minisat requirements
+#include <memory>
+#include "minisat/core/SolverTypes.h"
+#include "minisat/core/Solver.h"
+
+#include "VertexCover.h"
+
+namespace vc
+{
+
+using namespace std;
+
+// ------------------------ Storage Class Structures ------------------------ //
+
+// Edge
+typedef pair<uint32_t, uint32_t> Edge;
+
+// CSR layouts: the narrowest vertex id and row offset types that hold the graph. Ids are
+// 16 bits up to 65536 vertices; offsets are 64 bits once the neighbour array passes 2^32.
+enum GraphLayout
+{
+    CSR_NARROW, // uint16_t ids, uint32_t offsets
+    CSR_WIDE,   // uint32_t ids, uint32_t offsets
+    CSR_HUGE    // uint32_t ids, uint64_t offsets
+};
+
+// CsrView Class
+// Typed read-only view of a Graph's arrays. The solver kernels are templates over it, so each
+// layout gets its own instantiation whose inner loops read ids at their stored width.
+template <typename IdType, typename OffsetType>
+class CsrView
+{
+public:
+    typedef IdType Id;
+    typedef OffsetType Offset;
+
+private:
+    uint32_t v_count;
+    const Offset *offsets;
+    const Id *adj;
+
+public:
+    CsrView(uint32_t v_count, const Offset *offsets, const Id *adj)
+        : v_count(v_count), offsets(offsets), adj(adj)
+    {
+    }
+
+    uint32_t vertexCount() const
+    {
+        return this->v_count;
+    }
+
+    uint64_t edgeCount() const
+    {
+        return this->offsets[this->v_count] / 2;
+    }
+
+    uint32_t degree(uint32_t id) const
+    {
+        return this->offsets[id + 1] - this->offsets[id];
+    }
+
+    const Id *begin(uint32_t id) const
+    {
+        return this->adj + this->offsets[id];
+    }
+
+    const Id *end(uint32_t id) const
+    {
+        return this->adj + this->offsets[id + 1];
+    }
+};
+
+// Runs the statements with `view` bound to a pointer to the typed CsrView of graph. Solver
+// entry points dispatch once per graph; everything below them is instantiated per layout.
+#define CSR_DISPATCH(graph, view, ...)                                                \
+    do                                                                                \
+    {                                                                                 \
+        switch ((graph)->layout())                                                    \
+        {                                                                             \
+        case CSR_NARROW:                                                              \
+        {                                                                             \
+            const CsrView<uint16_t, uint32_t> view##_csr = (graph)->csr<uint16_t, uint32_t>(); \
+            const CsrView<uint16_t, uint32_t> *view = &view##_csr;                    \
+            __VA_ARGS__;                                                              \
+            break;                                                                    \
+        }                                                                             \
+        case CSR_WIDE:                                                                \
+        {                                                                             \
+            const CsrView<uint32_t, uint32_t> view##_csr = (graph)->csr<uint32_t, uint32_t>(); \
+            const CsrView<uint32_t, uint32_t> *view = &view##_csr;                    \
+            __VA_ARGS__;                                                              \
+            break;                                                                    \
+        }                                                                             \
+        default:                                                                      \
+        {                                                                             \
+            const CsrView<uint32_t, uint64_t> view##_csr = (graph)->csr<uint32_t, uint64_t>(); \
+            const CsrView<uint32_t, uint64_t> *view = &view##_csr;                    \
+            __VA_ARGS__;                                                              \
+            break;                                                                    \
+        }                                                                             \
+        }                                                                             \
+    } while (0)
+
+// Graph Class
+// Immutable CSR adjacency: the neighbours of v are adj[offsets[v] .. offsets[v + 1]), stored
+// in the narrowest GraphLayout that fits. Built once per 'E' command and shared read-only by
+// every solver thread, which read it through csr() or CSR_DISPATCH.
+class Graph
+{
+private:
+    uint32_t v_count = 0;
+    GraphLayout kind = CSR_NARROW;
+    // owned backing store of the current layout, empty when the arrays live in a mapped file
+    vector<uint32_t> offsets_store;
+    vector<uint64_t> wide_offsets_store;
+    vector<uint16_t> narrow_adj_store;
+    vector<uint32_t> adj_store;
+    shared_ptr<void> mapping;
+    // typed by kind: uint64_t offsets for CSR_HUGE, uint16_t ids for CSR_NARROW
+    const void *offsets = NULL;
+    const void *adj = NULL;
+    uint64_t adj_size = 0;
+
+    void bindStore()
+    {
+        this->mapping.reset();
+        if (this->kind == CSR_HUGE)
+        {
+            this->offsets = this->wide_offsets_store.data();
+            this->adj_size = this->wide_offsets_store[this->v_count];
+        }
+        else
+        {
+            this->offsets = this->offsets_store.data();
+            this->adj_size = this->offsets_store[this->v_count];
+        }
+        if (this->kind == CSR_NARROW)
+            this->adj = this->narrow_adj_store.data();
+        else
+            this->adj = this->adj_store.data();
+    }
+
+    // counting sort of both edge directions into the neighbour array
+    template <typename Id, typename Offset>
+    static void fill(uint32_t number, const vector<Edge> &edges, vector<Offset> &offsets, vector<Id> &adj)
+    {
+        offsets.assign(number + 1, 0);
+        for (const Edge &e : edges)
+        {
+            offsets[e.first + 1]++;
+            offsets[e.second + 1]++;
+        }
+        for (uint32_t v = 0; v < number; v++)
+            offsets[v + 1] += offsets[v];
+
+        adj.resize(offsets[number]);
+        vector<Offset> pos(offsets.begin(), offsets.end() - 1);
+        for (const Edge &e : edges)
+        {
+            adj[pos[e.first]++] = e.second;
+            adj[pos[e.second]++] = e.first;
+        }
+
+        // drop duplicate edges in place, O(1) per edge using a last-seen marker
+        vector<uint32_t> mark(number, UINT32_MAX);
+        Offset out = 0;
+        for (uint32_t v = 0; v < number; v++)
+        {
+            Offset first = offsets[v], last = offsets[v + 1];
+            offsets[v] = out;
+            for (Offset i = first; i < last; i++)
+            {
+                uint32_t u = adj[i];
+                if (mark[u] != v)
+                {
+                    mark[u] = v;
+                    adj[out++] = u;
+                }
+            }
+        }
+        offsets[number] = out;
+        adj.resize(out);
+        adj.shrink_to_fit();
+    }
+
+    // Checks a mapped file before any solver reads it: offsets, ids in range, and sorted
+    // neighbour lists without self-loops or duplicates where every u->v has its v->u
+    template <typename Offset>
+    static bool validate(uint64_t n, const Offset *offsets, const uint32_t *adj, const string &path, string &error)
+    {
+        for (uint64_t v = 0; v < n; v++)
+        {
+            if (offsets[v] > offsets[v + 1])
+            {
+                error = "Error: " + path + " has decreasing offsets";
+                return false;
+            }
+        }
+        for (uint64_t v = 0; v < n; v++)
+        {
+            for (Offset i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                if (adj[i] >= n)
+                {
+                    error = "Error: " + path + " has a neighbour out of range";
+                    return false;
+                }
+                if (adj[i] == v)
+                {
+                    error = "Error: " + path + " has a self-loop at " + to_string(v);
+                    return false;
+                }
+                if (i > offsets[v] && adj[i] <= adj[i - 1])
+                {
+                    error = "Error: " + path + " has an unsorted or duplicate neighbour of " + to_string(v);
+                    return false;
+                }
+            }
+        }
+        // the lists are sorted now, so the reverse of every edge is a binary search away
+        for (uint64_t v = 0; v < n; v++)
+        {
+            for (Offset i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                uint32_t u = adj[i];
+                if (!std::binary_search(adj + offsets[u], adj + offsets[u + 1], (uint32_t)v))
+                {
+                    error = "Error: " + path + " has edge <" + to_string(v) + "," + to_string(u) + "> in one direction only";
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+public:
+    Graph()
+    {
+        this->clear();
+    }
+
+    Graph(const Graph &other)
+    {
+        *this = other;
+    }
+
+    Graph &operator=(const Graph &other)
+    {
+        this->v_count = other.v_count;
+        this->kind = other.kind;
+        this->offsets_store = other.offsets_store;
+        this->wide_offsets_store = other.wide_offsets_store;
+        this->narrow_adj_store = other.narrow_adj_store;
+        this->adj_store = other.adj_store;
+        if (other.mapping)
+        {
+            // share the mapping rather than copying the file
+            this->mapping = other.mapping;
+            this->offsets = other.offsets;
+            this->adj = other.adj;
+            this->adj_size = other.adj_size;
+        }
+        else
+            this->bindStore();
+        return *this;
+    }
+
+    void build(uint32_t number, const vector<Edge> &edges)
+    {
+        this->v_count = number;
+        this->offsets_store.clear();
+        this->wide_offsets_store.clear();
+        this->narrow_adj_store.clear();
+        this->adj_store.clear();
+        // duplicates are only dropped after the counting sort, so size offsets for all of them
+        if (2 * (uint64_t)edges.size() > UINT32_MAX)
+            this->kind = CSR_HUGE;
+        else if (number <= (uint32_t)UINT16_MAX + 1)
+            this->kind = CSR_NARROW;
+        else
+            this->kind = CSR_WIDE;
+        if (this->kind == CSR_HUGE)
+            fill(number, edges, this->wide_offsets_store, this->adj_store);
+        else if (this->kind == CSR_NARROW)
+            fill(number, edges, this->offsets_store, this->narrow_adj_store);
+        else
+            fill(number, edges, this->offsets_store, this->adj_store);
+        this->bindStore();
+    }
+
+    // Maps a binary CSR file written by save() and reads it in place.
+    // Version 1: "VCSR", 1, vertex count, neighbour count, uint32 offsets[n + 1], adj[].
+    // Version 2, for neighbour arrays past 2^32: "VCSR", 2, vertex count, 0, uint64
+    // neighbour count, uint64 offsets[n + 1], adj[].
+    bool attach(const string &path, string &error)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            error = "Error: cannot open " + path;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 16)
+        {
+            close(fd);
+            error = "Error: " + path + " is not a binary CSR file";
+            return false;
+        }
+        size_t size = st.st_size;
+        void *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            error = "Error: cannot map " + path;
+            return false;
+        }
+        shared_ptr<void> owner(base, [size](void *p) { munmap(p, size); });
+
+        const uint32_t *header = (const uint32_t *)base;
+        uint64_t n = header[2], m = header[3];
+        GraphLayout kind = CSR_WIDE;
+        const void *offsets = NULL;
+        const uint32_t *adj = NULL;
+        string reason;
+        bool valid = memcmp(base, "VCSR", 4) == 0 && n <= INT32_MAX;
+        if (valid && header[1] == 2 && size >= 24)
+        {
+            // offsets start 8-byte aligned after the 24 byte header
+            const uint64_t *wide = (const uint64_t *)(header + 6);
+            m = *(const uint64_t *)(header + 4);
+            adj = (const uint32_t *)(wide + n + 1);
+            valid = m <= size && size == 24 + 8 * (n + 1) + 4 * m && wide[0] == 0 && wide[n] == m &&
+                    validate(n, wide, adj, path, reason);
+            kind = CSR_HUGE;
+            offsets = wide;
+        }
+        else if (valid && header[1] == 1)
+        {
+            // read in place, so the ids keep the file's width
+            adj = header + 5 + n;
+            valid = size == 16 + 4 * (n + 1 + m) && header[4] == 0 && header[4 + n] == m &&
+                    validate(n, header + 4, adj, path, reason);
+            offsets = header + 4;
+        }
+        else
+            valid = false;
+        if (!valid)
+        {
+            error = reason.empty() ? "Error: " + path + " is not a binary CSR file" : reason;
+            return false;
+        }
+
+        this->offsets_store.clear();
+        this->wide_offsets_store.clear();
+        this->narrow_adj_store.clear();
+        this->adj_store.clear();
+        this->mapping = owner;
+        this->v_count = n;
+        this->kind = kind;
+        this->offsets = offsets;
+        this->adj = adj;
+        this->adj_size = m;
+        return true;
+    }
+
+    // Writes version 1, or version 2 when the offsets need 64 bits
+    bool save(const string &path) const
+    {
+        FILE *out = fopen(path.c_str(), "wb");
+        if (out == NULL)
+            return false;
+        bool ok;
+        if (this->kind == CSR_HUGE)
+        {
+            uint32_t header[6] = {0, 2, this->v_count, 0};
+            memcpy(header, "VCSR", 4);
+            memcpy(header + 4, &this->adj_size, 8);
+            ok = fwrite(header, 4, 6, out) == 6 &&
+                 fwrite(this->offsets, 8, this->v_count + 1, out) == this->v_count + 1;
+        }
+        else
+        {
+            uint32_t header[4] = {0, 1, this->v_count, (uint32_t)this->adj_size};
+            memcpy(header, "VCSR", 4);
+            ok = fwrite(header, 4, 4, out) == 4 &&
+                 fwrite(this->offsets, 4, this->v_count + 1, out) == this->v_count + 1;
+        }
+        // the file format has 32-bit ids and sorted neighbour lists, which attach() checks
+        vector<uint32_t> chunk;
+        for (uint32_t v = 0; ok && v < this->v_count; v++)
+        {
+            size_t first = chunk.size();
+            this->neighbours(v, chunk);
+            std::sort(chunk.begin() + first, chunk.end());
+            if (chunk.size() >= 65536 || v + 1 == this->v_count)
+            {
+                ok = fwrite(chunk.data(), 4, chunk.size(), out) == chunk.size();
+                chunk.clear();
+            }
+        }
+        return fclose(out) == 0 && ok;
+    }
+
+    void clear()
+    {
+        this->v_count = 0;
+        this->kind = CSR_NARROW;
+        this->offsets_store.assign(1, 0);
+        this->wide_offsets_store.clear();
+        this->narrow_adj_store.clear();
+        this->adj_store.clear();
+        this->bindStore();
+    }
+
+    GraphLayout layout() const
+    {
+        return this->kind;
+    }
+
+    // The arrays as Id and Offset; the types must be those of layout()
+    template <typename Id, typename Offset>
+    CsrView<Id, Offset> csr() const
+    {
+        return CsrView<Id, Offset>(this->v_count, (const Offset *)this->offsets, (const Id *)this->adj);
+    }
+
+    uint32_t vertexCount() const
+    {
+        return this->v_count;
+    }
+
+    uint64_t edgeCount() const
+    {
+        return this->adj_size / 2;
+    }
+
+    uint32_t degree(uint32_t id) const
+    {
+        if (this->kind == CSR_HUGE)
+            return ((const uint64_t *)this->offsets)[id + 1] - ((const uint64_t *)this->offsets)[id];
+        return ((const uint32_t *)this->offsets)[id + 1] - ((const uint32_t *)this->offsets)[id];
+    }
+
+    // Appends the neighbours of id to out, for code outside the solvers' inner loops
+    void neighbours(uint32_t id, vector<uint32_t> &out) const
+    {
+        CSR_DISPATCH(this, view, out.insert(out.end(), view->begin(id), view->end(id)));
+    }
+};
+
+// GraphState Class
+// Per-solver mutable overlay on a shared Graph: current degrees and removed vertices.
+// Removing a vertex implicitly removes all of its incident edges. G is a CsrView.
+template <class G>
+class GraphState
+{
+private:
+    const G *graph;
+    vector<uint32_t> degrees;
+    vector<bool> removed;
+    uint64_t edge_count;
+
+public:
+    GraphState(const G *graph)
+    {
+        this->graph = graph;
+        uint32_t n = graph->vertexCount();
+        this->degrees.resize(n);
+        for (uint32_t v = 0; v < n; v++)
+            this->degrees[v] = graph->degree(v);
+        this->removed.assign(n, false);
+        this->edge_count = graph->edgeCount();
+    }
+
+    const G *get_graph() const
+    {
+        return this->graph;
+    }
+
+    uint32_t degree(uint32_t id) const
+    {
+        return this->degrees[id];
+    }
+
+    bool isRemoved(uint32_t id) const
+    {
+        return this->removed[id];
+    }
+
+    uint64_t edgeCount() const
+    {
+        return this->edge_count;
+    }
+
+    void removeVertex(uint32_t id)
+    {
+        if (this->removed[id])
+            return;
+        this->removed[id] = true;
+        for (const typename G::Id *it = this->graph->begin(id); it != this->graph->end(id); ++it)
+        {
+            if (!this->removed[*it])
+                this->degrees[*it]--;
+        }
+        this->edge_count -= this->degrees[id];
+        this->degrees[id] = 0;
+    }
+
+    // exact inverse of removeVertex when restores happen in reverse removal order
+    void restoreVertex(uint32_t id)
+    {
+        if (!this->removed[id])
+            return;
+        this->removed[id] = false;
+        uint32_t d = 0;
+        for (const typename G::Id *it = this->graph->begin(id); it != this->graph->end(id); ++it)
+        {
+            if (!this->removed[*it])
+            {
+                this->degrees[*it]++;
+                d++;
+            }
+        }
+        this->degrees[id] = d;
+        this->edge_count += d;
+    }
+};
+
+// DegreeQueue Class
+// Bucket priority queue over the live degrees of a GraphState. Each degree has an
+// intrusive doubly linked list of vertices, so moving a vertex down one bucket is O(1)
+// and a full greedy run costs O(V+E). Ties go to the vertex that entered its bucket
+// last; the initial fill runs from the highest id down, so among vertices whose degree
+// has not changed yet the lowest id still wins, as with a linear scan.
+template <class G>
+class DegreeQueue
+{
+private:
+    GraphState<G> *state;
+    vector<int> head;
+    vector<int> next;
+    vector<int> prev;
+    uint32_t top;
+
+    void link(uint32_t id)
+    {
+        uint32_t d = this->state->degree(id);
+        this->prev[id] = -1;
+        this->next[id] = this->head[d];
+        if (this->head[d] != -1)
+            this->prev[this->head[d]] = id;
+        this->head[d] = id;
+        if (this->top < d)
+            this->top = d;
+    }
+
+    void unlink(uint32_t id)
+    {
+        uint32_t d = this->state->degree(id);
+        if (this->prev[id] != -1)
+            this->next[this->prev[id]] = this->next[id];
+        else
+            this->head[d] = this->next[id];
+        if (this->next[id] != -1)
+            this->prev[this->next[id]] = this->prev[id];
+    }
+
+public:
+    DegreeQueue(GraphState<G> *state)
+    {
+        this->state = state;
+        uint32_t n = state->get_graph()->vertexCount();
+        this->top = 0;
+        for (uint32_t v = 0; v < n; v++)
+        {
+            if (this->top < state->degree(v))
+                this->top = state->degree(v);
+        }
+        this->head.assign(this->top + 1, -1);
+        this->next.assign(n, -1);
+        this->prev.assign(n, -1);
+        for (uint32_t v = n; v-- > 0;)
+        {
+            if (state->degree(v) > 0)
+                this->link(v);
+        }
+    }
+
+    // highest-degree live vertex; -1 when no edge is left
+    int maxNode()
+    {
+        while (this->top > 0 && this->head[this->top] == -1)
+            this->top--;
+        return this->top > 0 ? this->head[this->top] : -1;
+    }
+
+    // removes a vertex with all its edges and re-buckets its neighbours
+    void removeVertex(uint32_t id)
+    {
+        if (this->state->isRemoved(id))
+            return;
+        const G *g = this->state->get_graph();
+        if (this->state->degree(id) > 0)
+            this->unlink(id);
+        for (const typename G::Id *it = g->begin(id); it != g->end(id); ++it)
+        {
+            if (!this->state->isRemoved(*it))
+                this->unlink(*it);
+        }
+        this->state->removeVertex(id);
+        for (const typename G::Id *it = g->begin(id); it != g->end(id); ++it)
+        {
+            if (!this->state->isRemoved(*it) && this->state->degree(*it) > 0)
+                this->link(*it);
+        }
+    }
+};
+
+// Component
+// One connected component with at least one edge, renumbered from 0; origin maps back
+struct Component
+{
+    vector<uint32_t> origin;
+    Graph graph;
+};
+
+// Splits a graph into its connected components by BFS over the CSR arrays
+template <class G>
+static void split_components(const G *graph, vector<Component> &components)
+{
+    uint32_t n = graph->vertexCount();
+    vector<uint32_t> local(n, UINT32_MAX);
+    vector<Edge> edges;
+    components.clear();
+    for (uint32_t root = 0; root < n; root++)
+    {
+        if (local[root] != UINT32_MAX || graph->degree(root) == 0)
+            continue;
+        components.push_back(Component());
+        Component &c = components.back();
+        edges.clear();
+        local[root] = 0;
+        c.origin.push_back(root);
+        for (uint32_t head = 0; head < c.origin.size(); head++)
+        {
+            uint32_t u = c.origin[head];
+            for (const typename G::Id *it = graph->begin(u); it != graph->end(u); ++it)
+            {
+                if (local[*it] == UINT32_MAX)
+                {
+                    local[*it] = c.origin.size();
+                    c.origin.push_back(*it);
+                }
+                if (u < *it)
+                    edges.push_back(Edge(local[u], local[*it]));
+            }
+        }
+        c.graph.build(c.origin.size(), edges);
+    }
+}
+
+static void split_components(const Graph *graph, vector<Component> &components)
+{
+    CSR_DISPATCH(graph, view, split_components(view, components));
+}
+
+// SolveStats
+// Statistics of one exact solve; sums over the components of a decomposed graph
+struct SolveStats
+{
+    long double kernel_time = 0;
+    uint32_t kernel_vertices = 0;
+    // no cover is smaller than lower_bound; complete when the returned cover is optimal
+    uint32_t lower_bound = 0;
+    bool complete = true;
+};
+
+// GraphEdit
+// What the last incremental command changed, so the previous covers can be repaired
+// instead of recomputed. Vertex ids never change: vertices are only appended, and
+// removing one drops its edges.
+struct GraphEdit
+{
+    bool active = false;
+    vector<Edge> added;
+    // endpoints of removed edges, which may have become redundant in a cover
+    vector<uint32_t> touched;
+    // how far the optimum can have dropped: one per removed edge or isolated vertex
+    uint32_t decrease = 0;
+};
+
+// ------------------------ Time Execution related Functions ------------------------ //
+// Microseconds on clock cid, 0 when it cannot be read; library code must not exit over it
+static long double pclock(clockid_t cid)
+{
+    struct timespec ts;
+    if (clock_gettime(cid, &ts) == -1)
+        return 0;
+
+    return (ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+// Absolute CLOCK_REALTIME time at which exact solvers started now run out of the budget;
+// false when the clock cannot be read, leaving the caller without a deadline
+static bool budget_deadline(double time_budget, struct timespec &ts)
+{
+    if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
+        return false;
+    long long nsec = ts.tv_nsec + (long long)((time_budget - floor(time_budget)) * 1e9);
+    ts.tv_sec += (time_t)time_budget + nsec / 1000000000;
+    ts.tv_nsec = nsec % 1000000000;
+    return true;
+}
+
+// ------------------------ Tracing ------------------------ //
+// PerfCounters Class
+// Hardware counters of the calling thread through perf_event_open: cycles, cache misses and
+// branch misses. A counter the kernel refuses (no PMU, perf_event_paranoid) stays closed.
+class PerfCounters
+{
+public:
+    static const int COUNT = 3;
+
+private:
+    int fds[COUNT];
+
+public:
+    PerfCounters()
+    {
+        static const uint64_t configs[COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < COUNT; i++)
+        {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            this->fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+    }
+    ~PerfCounters()
+    {
+        for (int i = 0; i < COUNT; i++)
+        {
+            if (this->fds[i] >= 0)
+                close(this->fds[i]);
+        }
+    }
+    // false when no counter could be opened
+    bool read(uint64_t values[COUNT])
+    {
+        bool any = false;
+        for (int i = 0; i < COUNT; i++)
+        {
+            values[i] = 0;
+            if (this->fds[i] >= 0 && ::read(this->fds[i], &values[i], sizeof(uint64_t)) == sizeof(uint64_t))
+                any = true;
+        }
+        return any;
+    }
+    // counters of the calling thread, opened on first use
+    static PerfCounters &local()
+    {
+        static thread_local PerfCounters counters;
+        return counters;
+    }
+};
+
+// Tracer Class
+// Collects complete events ("ph": "X") from every thread and writes them as a Chrome trace
+// (chrome://tracing, Perfetto) on exit. Disabled until start(); solvers reach it through
+// SolverOptions::tracer.
+class Tracer
+{
+private:
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    string events;
+    long double origin = 0;
+
+public:
+    bool enabled = false;
+    bool perf = false;
+
+    void start(bool perf)
+    {
+        this->enabled = true;
+        this->perf = perf;
+        this->origin = pclock(CLOCK_MONOTONIC);
+    }
+
+    long double now()
+    {
+        return pclock(CLOCK_MONOTONIC) - this->origin;
+    }
+
+    void record(const char *name, const char *category, long double start, long double duration, const string &args)
+    {
+        string event = "{\"name\": \"" + string(name) + "\", \"cat\": \"" + category + "\", \"ph\": \"X\", \"ts\": " +
+                       to_string((uint64_t)start) + ", \"dur\": " + to_string((uint64_t)duration) + ", \"pid\": " +
+                       to_string(getpid()) + ", \"tid\": " + to_string(syscall(SYS_gettid)) + ", \"args\": {" + args + "}}";
+        pthread_mutex_lock(&this->lock);
+        this->events += (this->events.empty() ? "\n" : ",\n") + event;
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    bool write(const string &path)
+    {
+        ofstream out(path.c_str());
+        pthread_mutex_lock(&this->lock);
+        out << "{\"traceEvents\": [" << this->events << "\n], \"displayTimeUnit\": \"ms\"}" << endl;
+        pthread_mutex_unlock(&this->lock);
+        return out.good();
+    }
+};
+
+// MiniSat's search counters at one point in time
+struct SolverCounters
+{
+    uint64_t conflicts, decisions, propagations;
+    SolverCounters(const Minisat::Solver *solver)
+    {
+        this->conflicts = solver->conflicts;
+        this->decisions = solver->decisions;
+        this->propagations = solver->propagations;
+    }
+};
+
+// TraceScope Class
+// Times the enclosing block as one trace event of tracer, with the thread's hardware
+// counters under -perf. Costs a single branch when tracer is NULL or not started.
+class TraceScope
+{
+private:
+    Tracer *tracer;
+    const char *name, *category;
+    long double start = 0;
+    uint64_t counters[PerfCounters::COUNT];
+    bool counting = false;
+    string args;
+
+public:
+    TraceScope(Tracer *tracer, const char *name, const char *category)
+    {
+        this->tracer = tracer != NULL && tracer->enabled ? tracer : NULL;
+        this->name = name;
+        this->category = category;
+        if (this->tracer == NULL)
+            return;
+        if (this->tracer->perf)
+            this->counting = PerfCounters::local().read(this->counters);
+        this->start = this->tracer->now();
+    }
+    ~TraceScope()
+    {
+        if (this->tracer == NULL)
+            return;
+        long double end = this->tracer->now();
+        uint64_t counters[PerfCounters::COUNT];
+        if (this->counting && PerfCounters::local().read(counters))
+        {
+            this->arg("cycles", counters[0] - this->counters[0]);
+            this->arg("cache_misses", counters[1] - this->counters[1]);
+            this->arg("branch_misses", counters[2] - this->counters[2]);
+        }
+        this->tracer->record(this->name, this->category, this->start, end - this->start, this->args);
+    }
+
+    void arg(const char *key, int64_t value)
+    {
+        if (this->tracer == NULL)
+            return;
+        if (!this->args.empty())
+            this->args += ", ";
+        this->args += "\"" + string(key) + "\": " + to_string(value);
+    }
+    // search effort of one solve() since `before`, and the solver's size afterwards
+    void solver(const SolverCounters &before, const Minisat::Solver *solver)
+    {
+        this->arg("conflicts", solver->conflicts - before.conflicts);
+        this->arg("decisions", solver->decisions - before.decisions);
+        this->arg("propagations", solver->propagations - before.propagations);
+        this->arg("clauses", solver->nClauses());
+        this->arg("learnts", solver->nLearnts());
+    }
+};
+
+// ------------------------ Kernelization ------------------------ //
+// Kernel Class
+// Applies the classic vertex cover reductions exhaustively: isolated vertices, pendants,
+// degree-2 folding, domination and the high-degree rule against an upper bound. Works on
+// its own mutable adjacency lists, where folded vertices get fresh ids past the input
+// range, and emits the remaining kernel as a compact renumbered Graph. lift() maps a cover
+// of the kernel back to a cover of the input graph.
+class Kernel
+{
+private:
+    // v with non-adjacent neighbours u, w merged into the new vertex folded
+    struct Fold
+    {
+        uint32_t folded, v, u, w;
+    };
+
+    uint32_t input_count = 0;
+    vector<vector<uint32_t>> adj;
+    vector<uint32_t> deg;
+    vector<bool> removed;
+    vector<uint32_t> mark;
+    uint32_t stamp = 0;
+    vector<uint32_t> worklist;
+    vector<bool> queued;
+    vector<uint32_t> taken;
+    vector<Fold> folds;
+    int budget = 0;
+    vector<uint32_t> origin;
+
+    void push(uint32_t v)
+    {
+        if (!this->queued[v])
+        {
+            this->queued[v] = true;
+            this->worklist.push_back(v);
+        }
+    }
+
+    // drops removed entries from v's list so scans stay proportional to the live degree
+    void compact(uint32_t v)
+    {
+        vector<uint32_t> &list = this->adj[v];
+        if (list.size() == this->deg[v])
+            return;
+        unsigned int out = 0;
+        for (uint32_t u : list)
+        {
+            if (!this->removed[u])
+                list[out++] = u;
+        }
+        list.resize(out);
+    }
+
+    void nextStamp()
+    {
+        if (++this->stamp == 0)
+        {
+            std::fill(this->mark.begin(), this->mark.end(), 0);
+            this->stamp = 1;
+        }
+    }
+
+    void remove(uint32_t v)
+    {
+        this->removed[v] = true;
+        for (uint32_t u : this->adj[v])
+        {
+            if (!this->removed[u])
+            {
+                this->deg[u]--;
+                this->push(u);
+            }
+        }
+        this->adj[v].clear();
+        this->deg[v] = 0;
+    }
+
+    void take(uint32_t v)
+    {
+        this->taken.push_back(v);
+        this->budget--;
+        this->remove(v);
+    }
+
+    bool adjacent(uint32_t u, uint32_t w)
+    {
+        if (this->deg[u] > this->deg[w])
+            std::swap(u, w);
+        this->compact(u);
+        for (uint32_t x : this->adj[u])
+        {
+            if (x == w)
+                return true;
+        }
+        return false;
+    }
+
+    void fold(uint32_t v, uint32_t u, uint32_t w)
+    {
+        uint32_t folded = this->adj.size();
+        this->adj.push_back(vector<uint32_t>());
+        this->deg.push_back(0);
+        this->removed.push_back(false);
+        this->mark.push_back(0);
+        this->queued.push_back(false);
+        this->folds.push_back(Fold{folded, v, u, w});
+        this->budget--;
+
+        this->removed[v] = true;
+        this->adj[v].clear();
+        this->deg[v] = 0;
+        this->removed[u] = true;
+        this->removed[w] = true;
+        this->nextStamp();
+        for (uint32_t end : {u, w})
+        {
+            for (uint32_t x : this->adj[end])
+            {
+                if (this->removed[x])
+                    continue;
+                this->deg[x]--;
+                if (this->mark[x] != this->stamp)
+                {
+                    this->mark[x] = this->stamp;
+                    this->adj[folded].push_back(x);
+                    this->adj[x].push_back(folded);
+                    this->deg[x]++;
+                    this->deg[folded]++;
+                }
+                this->push(x);
+            }
+            this->adj[end].clear();
+            this->deg[end] = 0;
+        }
+        this->push(folded);
+    }
+
+    // domination: N[u] within N[x] means some minimum cover contains x. One count per
+    // neighbour answers both directions: c = |N(u) & N[x]| equals deg(u) when x dominates
+    // u and equals deg(x) when u dominates x.
+    bool dominate(uint32_t x)
+    {
+        this->compact(x);
+        this->nextStamp();
+        this->mark[x] = this->stamp;
+        for (uint32_t u : this->adj[x])
+            this->mark[u] = this->stamp;
+        for (uint32_t u : this->adj[x])
+        {
+            this->compact(u);
+            uint32_t c = 0;
+            for (uint32_t y : this->adj[u])
+            {
+                if (this->mark[y] == this->stamp)
+                    c++;
+            }
+            if (c == this->deg[u])
+            {
+                this->take(x);
+                return true;
+            }
+            if (c == this->deg[x])
+            {
+                this->take(u);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void reduceVertex(uint32_t v)
+    {
+        if (this->removed[v])
+            return;
+        if (this->deg[v] == 0)
+        {
+            this->removed[v] = true;
+            return;
+        }
+        this->compact(v);
+        if (this->deg[v] == 1)
+        {
+            this->take(this->adj[v][0]);
+            return;
+        }
+        if (this->budget >= 0 && (int)this->deg[v] > this->budget)
+        {
+            this->take(v);
+            return;
+        }
+        if (this->deg[v] == 2)
+        {
+            uint32_t u = this->adj[v][0], w = this->adj[v][1];
+            if (this->adjacent(u, w))
+            {
+                this->take(u);
+                this->take(w);
+            }
+            else
+                this->fold(v, u, w);
+            return;
+        }
+        this->dominate(v);
+    }
+
+public:
+    Graph graph;
+
+    // upper_bound is the size of any known cover of the input graph
+    void reduce(const Graph *input, int upper_bound)
+    {
+        uint32_t n = input->vertexCount();
+        this->input_count = n;
+        this->adj.assign(n, vector<uint32_t>());
+        this->deg.assign(n, 0);
+        for (uint32_t v = 0; v < n; v++)
+        {
+            this->adj[v].clear();
+            input->neighbours(v, this->adj[v]);
+            this->deg[v] = input->degree(v);
+        }
+        this->removed.assign(n, false);
+        this->mark.assign(n, 0);
+        this->queued.assign(n, false);
+        this->taken.clear();
+        this->folds.clear();
+        this->budget = upper_bound;
+        this->worklist.clear();
+        for (uint32_t v = n; v-- > 0;)
+            this->push(v);
+
+        while (!this->worklist.empty())
+        {
+            uint32_t v = this->worklist.back();
+            this->worklist.pop_back();
+            this->queued[v] = false;
+            this->reduceVertex(v);
+        }
+
+        // renumber what is left into a compact kernel graph
+        vector<uint32_t> index(this->adj.size(), UINT32_MAX);
+        this->origin.clear();
+        for (uint32_t v = 0; v < this->adj.size(); v++)
+        {
+            if (!this->removed[v] && this->deg[v] > 0)
+            {
+                index[v] = this->origin.size();
+                this->origin.push_back(v);
+            }
+        }
+        vector<Edge> edges;
+        for (uint32_t v : this->origin)
+        {
+            for (uint32_t u : this->adj[v])
+            {
+                if (!this->removed[u] && v < u)
+                    edges.push_back(Edge(index[v], index[u]));
+            }
+        }
+        this->graph.build(this->origin.size(), edges);
+    }
+
+    uint32_t forcedCount() const
+    {
+        return this->taken.size() + this->folds.size();
+    }
+
+    void lift(const vector<int> &kernel_cover, vector<int> &cover)
+    {
+        vector<bool> in_cover(this->adj.size(), false);
+        for (int id : kernel_cover)
+            in_cover[this->origin[id]] = true;
+        for (uint32_t v : this->taken)
+            in_cover[v] = true;
+        for (unsigned int i = this->folds.size(); i-- > 0;)
+        {
+            const Fold &f = this->folds[i];
+            if (in_cover[f.folded])
+            {
+                in_cover[f.u] = true;
+                in_cover[f.w] = true;
+            }
+            else
+                in_cover[f.v] = true;
+        }
+        cover.clear();
+        for (uint32_t v = 0; v < this->input_count; v++)
+        {
+            if (in_cover[v])
+                cover.push_back(v);
+        }
+    }
+};
+
+// ------------------------ Solvers Implementation ------------------------ //
+// Maximal matching in a single pass over the flat edge list; both endpoints of every
+// matched edge form a cover of at most twice the optimum
+static void maximal_matching_cover(const vector<Edge> &edges, uint32_t n, vector<int> &cover)
+{
+    vector<bool> matched(n, false);
+    for (const Edge &e : edges)
+    {
+        if (!matched[e.first] && !matched[e.second])
+        {
+            matched[e.first] = true;
+            matched[e.second] = true;
+            cover.push_back(e.first);
+            cover.push_back(e.second);
+        }
+    }
+}
+
+// Same kernel over the CSR arrays, visiting every edge once from its lower endpoint
+template <class G>
+static void maximal_matching_cover(const G *graph, vector<int> &cover)
+{
+    vector<bool> matched(graph->vertexCount(), false);
+    for (uint32_t u = 0; u < graph->vertexCount(); u++)
+    {
+        for (const typename G::Id *it = graph->begin(u); it != graph->end(u) && !matched[u]; ++it)
+        {
+            if (u < *it && !matched[*it])
+            {
+                matched[u] = true;
+                matched[*it] = true;
+                cover.push_back(u);
+                cover.push_back(*it);
+            }
+        }
+    }
+}
+
+static void maximal_matching_cover(const Graph *graph, vector<int> &cover)
+{
+    CSR_DISPATCH(graph, view, maximal_matching_cover(view, cover));
+}
+
+// StreamCover Class
+// Semi-streaming cover in O(V) memory for edge sets too large to store. The first pass keeps
+// a maximal matching as one bit per vertex, the same rule as maximal_matching_cover. An
+// optional second pass over the same edges drops cover vertices whose neighbours are all in
+// the cover: an edge with one cover endpoint pins it, and an edge between two unpinned cover
+// vertices pins the one of higher first-pass degree, so the unpinned vertices are
+// independent and every edge keeps a pinned endpoint.
+class StreamCover
+{
+private:
+    vector<bool> matched;
+    vector<bool> pinned;
+    vector<uint32_t> degrees;
+    bool pruning = false;
+    uint64_t matched_count = 0;
+    uint64_t missed = 0;
+
+public:
+    // counting keeps the degrees a later prune() needs
+    void reset(uint32_t n, bool counting)
+    {
+        this->matched.assign(n, false);
+        this->pinned.clear();
+        this->degrees.assign(counting ? n : 0, 0);
+        this->pruning = false;
+        this->matched_count = 0;
+        this->missed = 0;
+    }
+
+    // starts the second pass
+    void prune()
+    {
+        this->pinned.assign(this->matched.size(), false);
+        this->pruning = true;
+    }
+
+    void edge(uint32_t u, uint32_t v)
+    {
+        bool cu = this->matched[u], cv = this->matched[v];
+        if (!this->pruning)
+        {
+            if (!this->degrees.empty())
+            {
+                // saturates, the degrees only break ties
+                this->degrees[u] += this->degrees[u] != UINT32_MAX;
+                this->degrees[v] += this->degrees[v] != UINT32_MAX;
+            }
+            if (!cu && !cv)
+            {
+                this->matched[u] = true;
+                this->matched[v] = true;
+                this->matched_count++;
+            }
+        }
+        else if (cu && !cv)
+            this->pinned[u] = true;
+        else if (cv && !cu)
+            this->pinned[v] = true;
+        else if (cu && cv)
+        {
+            if (!this->pinned[u] && !this->pinned[v])
+                this->pinned[this->degrees[u] >= this->degrees[v] ? u : v] = true;
+        }
+        else
+            this->missed++;
+    }
+
+    bool contains(uint32_t v) const
+    {
+        return this->matched[v] && (!this->pruning || this->pinned[v]);
+    }
+
+    // no cover is smaller than the matching
+    uint64_t lowerBound() const
+    {
+        return this->matched_count;
+    }
+
+    // edges of the second pass that the first never saw, so the input changed in between
+    uint64_t missedEdges() const
+    {
+        return this->missed;
+    }
+};
+
+// Greedy cover: repeatedly takes a highest-degree vertex until no edge is left
+template <class G>
+static void max_degree_greedy_cover(const G *graph, vector<int> &cover)
+{
+    GraphState<G> state(graph);
+    DegreeQueue<G> queue(&state);
+    int target;
+    while ((target = queue.maxNode()) != -1)
+    {
+        cover.push_back(target);
+        queue.removeVertex(target);
+    }
+}
+
+static void max_degree_greedy_cover(const Graph *graph, vector<int> &cover)
+{
+    CSR_DISPATCH(graph, view, max_degree_greedy_cover(view, cover));
+}
+
+// Turns a cover of the graph before an edit into one of the current graph. An added edge
+// that is still uncovered gets both endpoints (APPROX-VC-2's rule) or the one of higher
+// degree; then touched vertices leave the cover when all of their neighbours are in it.
+template <class G>
+static void repair_cover(const G *graph, const GraphEdit &edit, bool both, vector<int> &cover)
+{
+    vector<bool> in(graph->vertexCount(), false);
+    for (int v : cover)
+        in[v] = true;
+    for (const Edge &e : edit.added)
+    {
+        if (in[e.first] || in[e.second])
+            continue;
+        if (both || graph->degree(e.first) >= graph->degree(e.second))
+            in[e.first] = true;
+        if (both || graph->degree(e.first) < graph->degree(e.second))
+            in[e.second] = true;
+    }
+    for (uint32_t v : edit.touched)
+    {
+        if (!in[v])
+            continue;
+        bool redundant = true;
+        for (const typename G::Id *it = graph->begin(v); it != graph->end(v) && redundant; ++it)
+            redundant = in[*it];
+        if (redundant)
+            in[v] = false;
+    }
+    cover.clear();
+    for (uint32_t v = 0; v < graph->vertexCount(); v++)
+    {
+        if (in[v])
+            cover.push_back(v);
+    }
+}
+
+static void repair_cover(const Graph *graph, const GraphEdit &edit, bool both, vector<int> &cover)
+{
+    CSR_DISPATCH(graph, view, repair_cover(view, edit, both, cover));
+}
+
+// LP relaxation lower bound. The LP optimum is half the maximum matching of the bipartite
+// double cover (a left and a right copy of every vertex, u_L - v_R for each edge u - v),
+// found here with Hopcroft-Karp, which is max-flow on the unit-capacity bipartite network.
+template <class G>
+static uint32_t lp_lower_bound(const G *graph)
+{
+    const uint32_t none = UINT32_MAX;
+    uint32_t n = graph->vertexCount();
+    vector<uint32_t> match_l(n, none), match_r(n, none), dist(n), queue, stack;
+    vector<const typename G::Id *> next(n);
+    uint32_t matched = 0;
+    for (uint32_t u = 0; u < n; u++)
+    {
+        for (const typename G::Id *it = graph->begin(u); it != graph->end(u); ++it)
+        {
+            if (match_r[*it] == none)
+            {
+                match_l[u] = *it;
+                match_r[*it] = u;
+                matched++;
+                break;
+            }
+        }
+    }
+
+    while (true)
+    {
+        // layer the left vertices by alternating path length from the free ones
+        queue.clear();
+        for (uint32_t u = 0; u < n; u++)
+        {
+            dist[u] = match_l[u] == none && graph->degree(u) > 0 ? 0 : none;
+            if (dist[u] == 0)
+                queue.push_back(u);
+        }
+        bool augmentable = false;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            uint32_t u = queue[head];
+            for (const typename G::Id *it = graph->begin(u); it != graph->end(u); ++it)
+            {
+                uint32_t w = match_r[*it];
+                if (w == none)
+                    augmentable = true;
+                else if (dist[w] == none)
+                {
+                    dist[w] = dist[u] + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+        if (!augmentable)
+            break;
+
+        // iterative DFS along the layers; next[u] is the edge u is currently trying
+        for (uint32_t u = 0; u < n; u++)
+            next[u] = graph->begin(u);
+        for (uint32_t root = 0; root < n; root++)
+        {
+            if (match_l[root] != none || dist[root] != 0)
+                continue;
+            stack.assign(1, root);
+            while (!stack.empty())
+            {
+                uint32_t u = stack.back();
+                if (next[u] == graph->end(u))
+                {
+                    dist[u] = none;
+                    stack.pop_back();
+                    if (!stack.empty())
+                        ++next[stack.back()];
+                    continue;
+                }
+                uint32_t w = match_r[*next[u]];
+                if (w == none)
+                {
+                    for (uint32_t x : stack)
+                    {
+                        match_l[x] = *next[x];
+                        match_r[*next[x]] = x;
+                    }
+                    matched++;
+                    break;
+                }
+                if (dist[w] == dist[u] + 1)
+                    stack.push_back(w);
+                else
+                    ++next[u];
+            }
+        }
+    }
+    return (matched + 1) / 2;
+}
+
+static uint32_t lp_lower_bound(const Graph *graph)
+{
+    CSR_DISPATCH(graph, view, return lp_lower_bound(view));
+    return 0;
+}
+
+// VCEncoding Class
+// A CNF-SAT-VC reduction that answers "is there a cover of size at most k". prepare(k)
+// readies the solver for one probe and solve() runs it. interrupt() may be called from
+// another thread between clearInterrupt() and the end of solve(), which then returns l_Undef.
+class VCEncoding
+{
+public:
+    virtual ~VCEncoding() {}
+    virtual void prepare(int k) = 0;
+    virtual Minisat::lbool solve(vector<int> &cover) = 0;
+    virtual void interrupt() = 0;
+    virtual void clearInterrupt() = 0;
+    // facts proven so far: there is no cover below lo and only covers below hi are wanted
+    virtual void learn(int lo, int hi) {}
+    // conflict limit for the next solve(), -1 for none, and conflicts spent over all solves
+    virtual void setBudget(int64_t conflicts) = 0;
+    virtual uint64_t conflicts() = 0;
+};
+
+// SolveControl Class
+// Options, cancellation and conflict budget shared by everything working on one exact run.
+// Encodings are registered with enter() while they solve, so cancel() from another thread
+// interrupts them; BranchAndReduce polls isCancelled(). The budget is the run's total over
+// all probes.
+class SolveControl
+{
+private:
+    pthread_mutex_t lock;
+    SolverOptions settings;
+    bool cancelled = false;
+    int64_t conflicts_left = -1;
+    vector<VCEncoding *> active;
+    const Graph *input = NULL;
+    vector<int> offered;
+    uint32_t floor = 0;
+
+public:
+    SolveControl()
+    {
+        pthread_mutex_init(&this->lock, NULL);
+    }
+
+    ~SolveControl()
+    {
+        pthread_mutex_destroy(&this->lock);
+    }
+
+    // input is the graph the run was started on, the only one offered covers apply to
+    void reset(const SolverOptions &options, const Graph *input)
+    {
+        pthread_mutex_lock(&this->lock);
+        this->settings = options;
+        this->cancelled = false;
+        this->conflicts_left = options.conflict_budget;
+        this->input = input;
+        this->offered.clear();
+        this->floor = 0;
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    // Warm start after an incremental edit: the repaired previous cover and the previous
+    // lower bound less what the edit can have removed
+    void seed(const vector<int> &cover, uint32_t floor)
+    {
+        this->offer(cover);
+        pthread_mutex_lock(&this->lock);
+        this->floor = floor;
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    // fixed between reset() and the end of the run, so read without the lock
+    const SolverOptions &options() const
+    {
+        return this->settings;
+    }
+
+    uint32_t lowerBound(const Graph *graph)
+    {
+        pthread_mutex_lock(&this->lock);
+        uint32_t floor = graph == this->input ? this->floor : 0;
+        pthread_mutex_unlock(&this->lock);
+        return floor;
+    }
+
+    // Upper bound from a solver running beside this one, e.g. an approximation's cover
+    void offer(const vector<int> &cover)
+    {
+        pthread_mutex_lock(&this->lock);
+        if (this->offered.empty() || cover.size() < this->offered.size())
+            this->offered = cover;
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    // Replaces cover by a smaller offered one; kernels and components are other graphs
+    // and never match, so only a run on the input itself picks offers up
+    bool improve(const Graph *graph, vector<int> &cover)
+    {
+        pthread_mutex_lock(&this->lock);
+        bool better = graph == this->input && !this->offered.empty() &&
+                      (cover.empty() || this->offered.size() < cover.size());
+        if (better)
+            cover = this->offered;
+        pthread_mutex_unlock(&this->lock);
+        return better;
+    }
+
+    void cancel()
+    {
+        pthread_mutex_lock(&this->lock);
+        this->cancelled = true;
+        for (VCEncoding *encoding : this->active)
+            encoding->interrupt();
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    bool isCancelled()
+    {
+        pthread_mutex_lock(&this->lock);
+        bool cancelled = this->cancelled;
+        pthread_mutex_unlock(&this->lock);
+        return cancelled;
+    }
+
+    // Arms an encoding for one solve(); false once the run is cancelled or out of conflicts
+    bool enter(VCEncoding *encoding)
+    {
+        pthread_mutex_lock(&this->lock);
+        bool allowed = !this->cancelled && this->conflicts_left != 0;
+        if (allowed)
+        {
+            encoding->clearInterrupt();
+            encoding->setBudget(this->conflicts_left);
+            this->active.push_back(encoding);
+        }
+        pthread_mutex_unlock(&this->lock);
+        return allowed;
+    }
+
+    void leave(VCEncoding *encoding, uint64_t spent)
+    {
+        pthread_mutex_lock(&this->lock);
+        this->active.erase(std::find(this->active.begin(), this->active.end(), encoding));
+        if (this->conflicts_left > 0)
+            this->conflicts_left -= std::min<uint64_t>(spent, this->conflicts_left);
+        pthread_mutex_unlock(&this->lock);
+    }
+};
+
+// BranchAndReduce Class
+// Exact vertex cover by branch and reduce on a GraphState overlay. Every search node applies
+// the pendant, triangle and high-degree rules, prunes with the larger of a greedy matching
+// and a greedy clique cover lower bound, then branches on a maximum degree vertex v: either
+// v is in the cover or all of its neighbours are. Every removal is a cover vertex, so the
+// partial cover doubles as the undo trail.
+template <class G>
+class BranchAndReduce
+{
+private:
+    const G *graph;
+    SolveControl *control;
+    bool stopped = false;
+    GraphState<G> state;
+    vector<uint32_t> cover;
+    vector<int> best;
+    vector<uint32_t> worklist;
+    vector<int> mate;
+    vector<int> clique_of;
+    vector<uint32_t> clique_size;
+    vector<uint32_t> clique_count;
+    vector<uint64_t> clique_tick;
+    uint64_t tick = 0;
+
+    void take(uint32_t v)
+    {
+        this->cover.push_back(v);
+        this->state.removeVertex(v);
+        for (const typename G::Id *it = this->graph->begin(v); it != this->graph->end(v); ++it)
+        {
+            if (!this->state.isRemoved(*it))
+                this->worklist.push_back(*it);
+        }
+    }
+
+    void undo(size_t mark)
+    {
+        while (this->cover.size() > mark)
+        {
+            this->state.restoreVertex(this->cover.back());
+            this->cover.pop_back();
+        }
+    }
+
+    int liveNeighbour(uint32_t v, int skip)
+    {
+        for (const typename G::Id *it = this->graph->begin(v); it != this->graph->end(v); ++it)
+        {
+            if (!this->state.isRemoved(*it) && (int)*it != skip)
+                return *it;
+        }
+        return -1;
+    }
+
+    bool adjacent(uint32_t u, uint32_t w)
+    {
+        if (this->graph->degree(u) > this->graph->degree(w))
+            std::swap(u, w);
+        for (const typename G::Id *it = this->graph->begin(u); it != this->graph->end(u); ++it)
+        {
+            if (*it == w)
+                return true;
+        }
+        return false;
+    }
+
+    // applies the reductions to a fixed point; false when this node cannot beat best
+    bool reduce()
+    {
+        while (!this->worklist.empty())
+        {
+            uint32_t v = this->worklist.back();
+            this->worklist.pop_back();
+            int budget = (int)this->best.size() - 1 - (int)this->cover.size();
+            if (budget < 0)
+            {
+                this->worklist.clear();
+                return false;
+            }
+            uint32_t d = this->state.degree(v);
+            if (this->state.isRemoved(v) || d == 0)
+                continue;
+            if (d == 1)
+                this->take(this->liveNeighbour(v, -1));
+            else if ((int)d > budget)
+                this->take(v);
+            else if (d == 2)
+            {
+                int u = this->liveNeighbour(v, -1);
+                int w = this->liveNeighbour(v, u);
+                if (this->adjacent(u, w))
+                {
+                    this->take(u);
+                    this->take(w);
+                }
+            }
+        }
+        return this->cover.size() < this->best.size();
+    }
+
+    uint32_t lowerBound()
+    {
+        uint32_t n = this->graph->vertexCount();
+        uint32_t matching = 0, vertices = 0, cliques = 0;
+        std::fill(this->mate.begin(), this->mate.end(), -1);
+        std::fill(this->clique_of.begin(), this->clique_of.end(), -1);
+        for (uint32_t v = 0; v < n; v++)
+        {
+            if (this->state.isRemoved(v) || this->state.degree(v) == 0)
+                continue;
+            vertices++;
+            this->tick++;
+            int joined = -1;
+            for (const typename G::Id *it = this->graph->begin(v); it != this->graph->end(v); ++it)
+            {
+                uint32_t u = *it;
+                if (this->state.isRemoved(u))
+                    continue;
+                if (this->mate[v] == -1 && this->mate[u] == -1)
+                {
+                    this->mate[v] = u;
+                    this->mate[u] = v;
+                    matching++;
+                }
+                int c = this->clique_of[u];
+                if (c == -1)
+                    continue;
+                if (this->clique_tick[c] != this->tick)
+                {
+                    this->clique_tick[c] = this->tick;
+                    this->clique_count[c] = 0;
+                }
+                if (++this->clique_count[c] == this->clique_size[c] && (joined == -1 || this->clique_size[c] > this->clique_size[joined]))
+                    joined = c;
+            }
+            if (joined == -1)
+            {
+                joined = cliques++;
+                this->clique_size[joined] = 0;
+                this->clique_tick[joined] = 0;
+            }
+            this->clique_of[v] = joined;
+            this->clique_size[joined]++;
+        }
+        return std::max(matching, vertices - cliques);
+    }
+
+    void search()
+    {
+        if (this->stopped || (this->stopped = this->control->isCancelled()))
+            return;
+        size_t mark = this->cover.size();
+        if (this->reduce())
+        {
+            int v = -1;
+            uint32_t degree = 0;
+            for (uint32_t u = 0; u < this->graph->vertexCount(); u++)
+            {
+                if (degree < this->state.degree(u))
+                {
+                    degree = this->state.degree(u);
+                    v = u;
+                }
+            }
+            if (v == -1)
+                this->best.assign(this->cover.begin(), this->cover.end());
+            else if (this->cover.size() + this->lowerBound() < this->best.size())
+            {
+                size_t reduced = this->cover.size();
+                this->take(v);
+                this->search();
+                this->undo(reduced);
+
+                if (reduced + degree < this->best.size())
+                {
+                    vector<uint32_t> neighbours;
+                    for (const typename G::Id *it = this->graph->begin(v); it != this->graph->end(v); ++it)
+                    {
+                        if (!this->state.isRemoved(*it))
+                            neighbours.push_back(*it);
+                    }
+                    for (uint32_t u : neighbours)
+                        this->take(u);
+                    this->search();
+                    this->undo(reduced);
+                }
+            }
+        }
+        this->worklist.clear();
+        this->undo(mark);
+    }
+
+public:
+    BranchAndReduce(const G *graph, SolveControl *control) : state(graph)
+    {
+        this->graph = graph;
+        this->control = control;
+        uint32_t n = graph->vertexCount();
+        this->mate.assign(n, -1);
+        this->clique_of.assign(n, -1);
+        this->clique_size.assign(n, 0);
+        this->clique_count.assign(n, 0);
+        this->clique_tick.assign(n, 0);
+    }
+
+    // upper is any valid cover, used as the incumbent; on cancellation result is the best
+    // cover found and the return value the root lower bound, otherwise the optimum's size
+    uint32_t solve(const vector<int> &upper, vector<int> &result)
+    {
+        this->best = upper;
+        uint32_t bound = this->lowerBound();
+        for (uint32_t v = this->graph->vertexCount(); v-- > 0;)
+            this->worklist.push_back(v);
+        this->search();
+        result = this->best;
+        return this->stopped ? std::min<uint32_t>(bound, result.size()) : result.size();
+    }
+};
+
+// DenseSolver Class
+// Exact vertex cover of small dense graphs: the complement of a maximum independent set, which
+// is a maximum clique of the complement graph. The clique search is bitset branch and bound
+// (BBMC): candidate sets are rows of 64-bit words, a greedy colouring built with word-wise
+// AND-NOT bounds every branch, and vertices are renumbered by non-increasing degree in the
+// complement so the colouring takes them first.
+class DenseSolver
+{
+public:
+    static const uint32_t MAX_VERTICES = 512;
+
+private:
+    SolveControl *control;
+    uint32_t n, words;
+    vector<uint32_t> order;     // bit i stands for input vertex order[i]
+    vector<uint64_t> adjacency; // complement rows, words per vertex
+    vector<uint64_t> levels;    // candidate set of every depth, then two colouring scratch rows
+    vector<vector<uint32_t>> level_vertices, level_colours;
+    vector<uint32_t> clique, best;
+    uint64_t nodes = 0;
+    bool stopped = false;
+
+    const uint64_t *row(uint32_t v) const
+    {
+        return &this->adjacency[(size_t)v * this->words];
+    }
+    uint64_t *level(uint32_t depth)
+    {
+        return &this->levels[(size_t)depth * this->words];
+    }
+
+    // Greedy colour classes of the candidates; only vertices whose colour can still beat
+    // the incumbent are listed, in increasing colour. Returns the number of colours.
+    uint32_t colour(const uint64_t *candidates, uint32_t kmin, vector<uint32_t> &vertices, vector<uint32_t> &colours)
+    {
+        uint64_t *uncoloured = this->level(this->n + 1);
+        uint64_t *open = this->level(this->n + 2);
+        std::copy(candidates, candidates + this->words, uncoloured);
+        vertices.clear();
+        colours.clear();
+        uint32_t k = 0;
+        uint32_t first = 0;
+        while (true)
+        {
+            while (first < this->words && uncoloured[first] == 0)
+                first++;
+            if (first == this->words)
+                return k;
+            k++;
+            std::copy(uncoloured + first, uncoloured + this->words, open + first);
+            for (uint32_t w = first; w < this->words; w++)
+            {
+                while (open[w] != 0)
+                {
+                    uint32_t v = w * 64 + __builtin_ctzll(open[w]);
+                    uint64_t bit = ~(1ULL << (v & 63));
+                    open[w] &= bit;
+                    uncoloured[w] &= bit;
+                    // a vertex's class may not hold its neighbours in the complement
+                    const uint64_t *neighbours = this->row(v);
+                    for (uint32_t x = w; x < this->words; x++)
+                        open[x] &= ~neighbours[x];
+                    if (k >= kmin)
+                    {
+                        vertices.push_back(v);
+                        colours.push_back(k);
+                    }
+                }
+            }
+        }
+    }
+
+    void expand(uint32_t depth)
+    {
+        if (this->stopped || ((++this->nodes & 1023) == 0 && (this->stopped = this->control->isCancelled())))
+            return;
+        uint64_t *candidates = this->level(depth);
+        uint64_t *next = this->level(depth + 1);
+        vector<uint32_t> &vertices = this->level_vertices[depth];
+        vector<uint32_t> &colours = this->level_colours[depth];
+        uint32_t kmin = this->best.size() >= this->clique.size() ? this->best.size() - this->clique.size() + 1 : 1;
+        this->colour(candidates, kmin, vertices, colours);
+
+        for (size_t i = vertices.size(); i-- > 0;)
+        {
+            if (this->stopped || this->clique.size() + colours[i] <= this->best.size())
+                return;
+            uint32_t v = vertices[i];
+            const uint64_t *neighbours = this->row(v);
+            bool empty = true;
+            for (uint32_t w = 0; w < this->words; w++)
+            {
+                next[w] = candidates[w] & neighbours[w];
+                empty = empty && next[w] == 0;
+            }
+            this->clique.push_back(v);
+            if (empty)
+            {
+                if (this->clique.size() > this->best.size())
+                    this->best = this->clique;
+            }
+            else
+                this->expand(depth + 1);
+            this->clique.pop_back();
+            candidates[v / 64] &= ~(1ULL << (v & 63));
+        }
+    }
+
+public:
+    template <class G>
+    DenseSolver(const G *graph, SolveControl *control)
+    {
+        this->control = control;
+        this->n = graph->vertexCount();
+        this->words = (this->n + 63) / 64;
+        this->order.resize(this->n);
+        for (uint32_t v = 0; v < this->n; v++)
+            this->order[v] = v;
+        // non-increasing complement degree is non-decreasing degree
+        std::stable_sort(this->order.begin(), this->order.end(), [graph](uint32_t a, uint32_t b) {
+            return graph->degree(a) < graph->degree(b);
+        });
+        vector<uint32_t> position(this->n);
+        for (uint32_t i = 0; i < this->n; i++)
+            position[this->order[i]] = i;
+
+        this->adjacency.assign((size_t)this->n * this->words, 0);
+        for (uint32_t i = 0; i < this->n; i++)
+        {
+            uint64_t *bits = &this->adjacency[(size_t)i * this->words];
+            for (uint32_t j = 0; j < this->n; j++)
+                bits[j / 64] |= 1ULL << (j & 63);
+            bits[i / 64] &= ~(1ULL << (i & 63));
+            uint32_t v = this->order[i];
+            for (const typename G::Id *it = graph->begin(v); it != graph->end(v); ++it)
+                bits[position[*it] / 64] &= ~(1ULL << (position[*it] & 63));
+        }
+        this->levels.assign((size_t)(this->n + 3) * this->words, 0);
+        this->level_vertices.resize(this->n + 1);
+        this->level_colours.resize(this->n + 1);
+    }
+
+    // Minimum cover in result, or the best found when cancelled; upper is a known cover.
+    // Returns the lower bound: the cover size when finished, otherwise n minus the
+    // number of colours of the whole graph.
+    uint32_t solve(const vector<int> &upper, vector<int> &result)
+    {
+        vector<uint32_t> position(this->n);
+        for (uint32_t i = 0; i < this->n; i++)
+            position[this->order[i]] = i;
+        vector<bool> covered(this->n, false);
+        for (int v : upper)
+            covered[v] = true;
+        this->best.clear();
+        for (uint32_t v = 0; v < this->n; v++)
+        {
+            if (!covered[v])
+                this->best.push_back(position[v]);
+        }
+
+        uint64_t *root = this->level(0);
+        for (uint32_t v = 0; v < this->n; v++)
+            root[v / 64] |= 1ULL << (v & 63);
+        vector<uint32_t> vertices, colours;
+        uint32_t bound = this->colour(root, 1, vertices, colours);
+        if (this->best.size() < bound)
+            this->expand(0);
+
+        vector<bool> independent(this->n, false);
+        for (uint32_t i : this->best)
+            independent[this->order[i]] = true;
+        result.clear();
+        for (uint32_t v = 0; v < this->n; v++)
+        {
+            if (!independent[v])
+                result.push_back(v);
+        }
+        return this->stopped ? this->n - bound : result.size();
+    }
+};
+
+// LocalSearch Class
+// NuMVC-style edge-weighting local search. It keeps a candidate cover C and, whenever C
+// covers every edge, records it and drops a vertex to aim one lower. Each step swaps a
+// vertex out of C (best dscore among a random sample of C, as in FastVC) for an endpoint
+// of a random uncovered edge whose configuration changed since it last left C. Uncovered
+// edges gain weight every step, and weights are scaled down once their average passes
+// gamma. dscore(v) is the change in uncovered weight when v leaves or joins C, kept
+// up to date incrementally.
+template <class G>
+class LocalSearch
+{
+private:
+    // edge ids count up to the neighbour array's size, so they take the offset type
+    typedef typename G::Id Id;
+    typedef typename G::Offset EdgeId;
+
+    const G *graph;
+    vector<Id> edge_u, edge_v;
+    vector<EdgeId> incidence_offsets, incidence;
+    vector<int64_t> weight;
+    vector<int64_t> dscore;
+    vector<uint64_t> age;
+    vector<bool> in_cover, conf_change;
+    vector<uint32_t> members, member_pos;
+    vector<EdgeId> uncovered, uncovered_pos;
+    int64_t total_weight = 0;
+    uint64_t step = 0;
+    uint64_t rng = 88172645463325252ULL;
+
+    uint64_t random()
+    {
+        this->rng ^= this->rng << 13;
+        this->rng ^= this->rng >> 7;
+        this->rng ^= this->rng << 17;
+        return this->rng;
+    }
+
+    uint32_t other(EdgeId e, uint32_t v)
+    {
+        return this->edge_u[e] == v ? this->edge_v[e] : this->edge_u[e];
+    }
+
+    void uncover(EdgeId e)
+    {
+        this->uncovered_pos[e] = this->uncovered.size();
+        this->uncovered.push_back(e);
+    }
+
+    void cover(EdgeId e)
+    {
+        EdgeId last = this->uncovered.back();
+        this->uncovered[this->uncovered_pos[e]] = last;
+        this->uncovered_pos[last] = this->uncovered_pos[e];
+        this->uncovered.pop_back();
+    }
+
+    void add(uint32_t v)
+    {
+        this->in_cover[v] = true;
+        this->dscore[v] = -this->dscore[v];
+        this->member_pos[v] = this->members.size();
+        this->members.push_back(v);
+        this->age[v] = this->step;
+        for (EdgeId i = this->incidence_offsets[v]; i < this->incidence_offsets[v + 1]; i++)
+        {
+            EdgeId e = this->incidence[i];
+            uint32_t x = this->other(e, v);
+            if (this->in_cover[x])
+                this->dscore[x] += this->weight[e];
+            else
+            {
+                this->dscore[x] -= this->weight[e];
+                this->conf_change[x] = true;
+                this->cover(e);
+            }
+        }
+    }
+
+    void remove(uint32_t v)
+    {
+        this->in_cover[v] = false;
+        this->dscore[v] = -this->dscore[v];
+        this->conf_change[v] = false;
+        uint32_t last = this->members.back();
+        this->members[this->member_pos[v]] = last;
+        this->member_pos[last] = this->member_pos[v];
+        this->members.pop_back();
+        this->age[v] = this->step;
+        for (EdgeId i = this->incidence_offsets[v]; i < this->incidence_offsets[v + 1]; i++)
+        {
+            EdgeId e = this->incidence[i];
+            uint32_t x = this->other(e, v);
+            if (this->in_cover[x])
+                this->dscore[x] -= this->weight[e];
+            else
+            {
+                this->dscore[x] += this->weight[e];
+                this->conf_change[x] = true;
+                this->uncover(e);
+            }
+        }
+    }
+
+    // higher dscore wins, then the vertex that has not moved for longer
+    bool better(uint32_t a, uint32_t b)
+    {
+        return this->dscore[a] > this->dscore[b] || (this->dscore[a] == this->dscore[b] && this->age[a] < this->age[b]);
+    }
+
+    // best of `samples` random members of C, or of all of them; skips the vertex that just
+    // joined unless it is the only one
+    uint32_t bestMember(uint32_t samples, uint32_t tabu)
+    {
+        uint32_t size = this->members.size(), best = UINT32_MAX;
+        for (uint32_t i = 0; i < std::min(samples, size); i++)
+        {
+            uint32_t v = this->members[samples >= size ? i : this->random() % size];
+            if (v != tabu && (best == UINT32_MAX || this->better(v, best)))
+                best = v;
+        }
+        if (best == UINT32_MAX)
+            best = this->members[0] != tabu ? this->members[0] : this->members[size - 1];
+        return best;
+    }
+
+    // w(e) := max(1, rho * w(e)) for every edge, then rebuild the scores from scratch
+    void forget(double rho)
+    {
+        std::fill(this->dscore.begin(), this->dscore.end(), 0);
+        this->total_weight = 0;
+        for (EdgeId e = 0; e < this->weight.size(); e++)
+        {
+            this->weight[e] = std::max<int64_t>(1, this->weight[e] * rho);
+            this->total_weight += this->weight[e];
+            uint32_t u = this->edge_u[e], v = this->edge_v[e];
+            if (this->in_cover[u] && !this->in_cover[v])
+                this->dscore[u] -= this->weight[e];
+            else if (this->in_cover[v] && !this->in_cover[u])
+                this->dscore[v] -= this->weight[e];
+            else if (!this->in_cover[u] && !this->in_cover[v])
+            {
+                this->dscore[u] += this->weight[e];
+                this->dscore[v] += this->weight[e];
+            }
+        }
+    }
+
+public:
+    LocalSearch(const G *graph)
+    {
+        this->graph = graph;
+        uint32_t n = graph->vertexCount();
+        this->incidence_offsets.assign(n + 1, 0);
+        for (uint32_t u = 0; u < n; u++)
+        {
+            this->incidence_offsets[u + 1] = this->incidence_offsets[u] + graph->degree(u);
+            for (const Id *it = graph->begin(u); it != graph->end(u); ++it)
+            {
+                if (u < *it)
+                {
+                    this->edge_u.push_back(u);
+                    this->edge_v.push_back(*it);
+                }
+            }
+        }
+        vector<EdgeId> pos(this->incidence_offsets.begin(), this->incidence_offsets.end() - 1);
+        this->incidence.resize(this->incidence_offsets[n]);
+        for (EdgeId e = 0; e < this->edge_u.size(); e++)
+        {
+            this->incidence[pos[this->edge_u[e]]++] = e;
+            this->incidence[pos[this->edge_v[e]]++] = e;
+        }
+    }
+
+    // Improves the valid cover `start` until `seconds` of wall time have passed and
+    // returns the smallest cover seen
+    void solve(const vector<int> &start, double seconds, vector<int> &result)
+    {
+        uint32_t n = this->graph->vertexCount();
+        EdgeId m = this->edge_u.size();
+        const uint32_t samples = 50;
+        const double gamma = 0.5 * n, rho = 0.3;
+        this->weight.assign(m, 1);
+        this->total_weight = m;
+        this->dscore.assign(n, 0);
+        this->age.assign(n, 0);
+        this->in_cover.assign(n, false);
+        this->conf_change.assign(n, true);
+        this->member_pos.assign(n, 0);
+        this->members.clear();
+        this->uncovered_pos.assign(m, 0);
+        this->uncovered.clear();
+
+        // start from an empty C with every edge uncovered, then add the start cover
+        for (EdgeId e = 0; e < m; e++)
+        {
+            this->uncover(e);
+            this->dscore[this->edge_u[e]]++;
+            this->dscore[this->edge_v[e]]++;
+        }
+        for (int v : start)
+            this->add(v);
+        result = start;
+        if (m == 0)
+            return;
+
+        long double deadline = pclock(CLOCK_MONOTONIC) + seconds * 1000000;
+        uint32_t tabu = UINT32_MAX;
+        // a clock that reads 0 cannot tell the deadline, so the search stops rather than spin
+        long double now;
+        while ((this->step & 1023) != 0 || ((now = pclock(CLOCK_MONOTONIC)) > 0 && now < deadline))
+        {
+            this->step++;
+            if (this->uncovered.empty())
+            {
+                result.assign(this->members.begin(), this->members.end());
+                this->remove(this->bestMember(UINT32_MAX, UINT32_MAX));
+                tabu = UINT32_MAX;
+                continue;
+            }
+
+            if (!this->members.empty())
+                this->remove(this->bestMember(samples, tabu));
+
+            EdgeId e = this->uncovered[this->random() % this->uncovered.size()];
+            uint32_t a = this->edge_u[e], b = this->edge_v[e];
+            uint32_t v;
+            if (!this->conf_change[a])
+                v = b;
+            else if (!this->conf_change[b])
+                v = a;
+            else
+                v = this->better(a, b) ? a : b;
+            this->add(v);
+            tabu = v;
+
+            for (EdgeId x : this->uncovered)
+            {
+                this->weight[x]++;
+                this->dscore[this->edge_u[x]]++;
+                this->dscore[this->edge_v[x]]++;
+            }
+            this->total_weight += this->uncovered.size();
+            if (this->total_weight > gamma * m)
+                this->forget(rho);
+        }
+    }
+};
+
+// Diversified solver settings for portfolio member `config`; config 0 keeps the defaults
+static void configure_solver(Minisat::Solver *solver, int config)
+{
+    if (config == 0)
+        return;
+    const double decays[] = {0.95, 0.85, 0.9, 0.99};
+    solver->random_seed = 91648253 + 7919.0 * config;
+    solver->rnd_init_act = true;
+    solver->random_var_freq = (config % 2) ? 0.02 : 0;
+    solver->phase_saving = config % 3;
+    solver->luby_restart = (config % 4) < 2;
+    solver->restart_first = (config % 2) ? 50 : 100;
+    solver->var_decay = decays[config % 4];
+}
+
+// CounterEncoding Class
+// One variable x_v per vertex, a clause (x_u | x_v) per edge and a sequential counter over
+// the x_v. s[i][j-1] is forced true when at least j of the first i+1 counted vertices are in
+// the cover, so assuming ~s[last][k] bounds the cover by k. The solver is built once and
+// every probe only changes the assumption, so learnt clauses carry over.
+class CounterEncoding : public VCEncoding
+{
+private:
+    std::unique_ptr<Minisat::Solver> solver;
+    vector<Minisat::Var> x;
+    vector<uint32_t> counted;
+    vector<Minisat::Lit> total;
+    Minisat::vec<Minisat::Lit> assumptions;
+    int k = 0;
+    int known_lo = 0, known_hi = INT32_MAX;
+    Tracer *tracer;
+
+public:
+    // width is the size of a known cover; probes must stay below it
+    CounterEncoding(const Graph *graph, int width, int config, Tracer *tracer) : solver(new Minisat::Solver())
+    {
+        this->tracer = tracer;
+        TraceScope trace(tracer, "encode", "cnf");
+        configure_solver(this->solver.get(), config);
+        int n = graph->vertexCount();
+        this->x.resize(n);
+        for (int v = 0; v < n; v++)
+        {
+            this->x[v] = this->solver->newVar();
+            if (graph->degree(v) > 0)
+                this->counted.push_back(v);
+            else
+                this->solver->addClause(~Minisat::mkLit(this->x[v]));
+        }
+
+        vector<uint32_t> neighbours;
+        for (uint32_t u = 0; u < graph->vertexCount(); u++)
+        {
+            neighbours.clear();
+            graph->neighbours(u, neighbours);
+            for (uint32_t w : neighbours)
+            {
+                if (u < w)
+                    this->solver->addClause(Minisat::mkLit(this->x[u]), Minisat::mkLit(this->x[w]));
+            }
+        }
+
+        // row i only needs min(i + 1, width) counter bits
+        vector<Minisat::Lit> prev, row;
+        for (unsigned int i = 0; i < this->counted.size(); i++)
+        {
+            Minisat::Lit xi = Minisat::mkLit(this->x[this->counted[i]]);
+            row.clear();
+            for (int j = 0; j < std::min<int>(i + 1, width); j++)
+                row.push_back(Minisat::mkLit(this->solver->newVar()));
+
+            this->solver->addClause(~xi, row[0]);
+            for (unsigned int j = 0; j < prev.size(); j++)
+            {
+                this->solver->addClause(~prev[j], row[j]);
+                if (j + 1 < row.size())
+                    this->solver->addClause(~xi, ~prev[j], row[j + 1]);
+            }
+            prev.swap(row);
+        }
+        this->total = prev;
+        trace.arg("width", width);
+        trace.arg("clauses", this->solver->nClauses());
+    }
+
+    void prepare(int k)
+    {
+        this->k = k;
+        this->assumptions.clear();
+        this->assumptions.push(~this->total[k]);
+    }
+
+    void interrupt()
+    {
+        this->solver->interrupt();
+    }
+
+    void clearInterrupt()
+    {
+        this->solver->clearInterrupt();
+    }
+
+    void setBudget(int64_t conflicts)
+    {
+        if (conflicts < 0)
+            this->solver->budgetOff();
+        else
+            this->solver->setConfBudget(conflicts);
+    }
+
+    uint64_t conflicts()
+    {
+        return this->solver->conflicts;
+    }
+
+    Minisat::lbool solve(vector<int> &cover)
+    {
+        TraceScope trace(this->tracer, "solve", "cnf");
+        SolverCounters before(this->solver.get());
+        Minisat::lbool res = this->solver->solveLimited(this->assumptions);
+        trace.arg("k", this->k);
+        trace.arg("sat", res == l_True);
+        trace.solver(before, this->solver.get());
+        if (res == l_True)
+        {
+            TraceScope decode(this->tracer, "decode", "cnf");
+            cover.clear();
+            for (uint32_t v : this->counted)
+            {
+                if (this->solver->modelValue(this->x[v]) == l_True)
+                    cover.push_back(v);
+            }
+        }
+        return res;
+    }
+
+    void learn(int lo, int hi)
+    {
+        if (lo > this->known_lo && lo >= 1 && lo <= (int)this->total.size())
+            this->solver->addClause(this->total[lo - 1]);
+        if (hi < this->known_hi && hi >= 1 && hi <= (int)this->total.size())
+            this->solver->addClause(~this->total[hi - 1]);
+        this->known_lo = std::max(this->known_lo, lo);
+        this->known_hi = std::min(this->known_hi, hi);
+    }
+};
+
+// PairwiseEncoding Class
+// Position table encoding: n*k literals, every position holds exactly one vertex, every
+// vertex takes at most one position and every edge has an endpoint in some position.
+// The table depends on k, so each probe builds a fresh solver.
+class PairwiseEncoding : public VCEncoding
+{
+private:
+    const Graph *graph;
+    std::unique_ptr<Minisat::Solver> solver;
+    vector<vector<Minisat::Lit>> literals_table;
+    int k = 0;
+    int config;
+    uint64_t spent = 0;
+    Tracer *tracer;
+
+public:
+    PairwiseEncoding(const Graph *graph, int config, Tracer *tracer) : solver(new Minisat::Solver())
+    {
+        this->graph = graph;
+        this->config = config;
+        this->tracer = tracer;
+    }
+
+    void prepare(int k)
+    {
+        TraceScope trace(this->tracer, "encode", "cnf");
+        //de-allocates existing solver and allocates a new one in its place.
+        this->solver.reset(new Minisat::Solver());
+        configure_solver(this->solver.get(), this->config);
+        this->k = k;
+        int n = this->graph->vertexCount();
+
+        // creating the literal table
+        this->literals_table.clear();
+        vector<Minisat::Lit> tempRow;
+        for (int i = 0; i < n; i++)
+        {
+            tempRow.clear();
+            for (int j = 0; j < k; j++)
+            {
+                tempRow.push_back(Minisat::mkLit(this->solver->newVar()));
+            }
+            this->literals_table.push_back(tempRow);
+        }
+        const vector<vector<Minisat::Lit>> &literals_table = this->literals_table;
+        Minisat::Solver *solver = this->solver.get();
+
+        Minisat::vec<Minisat::Lit> tempClause;
+        // Reduction: part 1
+        for (int j = 0; j < k; j++)
+        {
+            tempClause.clear();
+            for (int i = 0; i < n; i++)
+            {
+                tempClause.push(literals_table[i][j]);
+            }
+            solver->addClause(tempClause);
+        }
+
+        // Reduction: part 2
+        for (int m = 0; m < n; m++)
+        {
+            for (int q = 1; q < k; q++)
+            {
+                for (int p = 0; p < q; p++)
+                    solver->addClause(~literals_table[m][p], ~literals_table[m][q]);
+            }
+        }
+
+        // Reduction: part 3
+        for (int m = 0; m < k; m++)
+        {
+            for (int q = 1; q < n; q++)
+            {
+                for (int p = 0; p < q; p++)
+                    solver->addClause(~literals_table[p][m], ~literals_table[q][m]);
+            }
+        }
+
+        // Reduction: part 4
+        vector<uint32_t> neighbours;
+        for (uint32_t i_id = 0; i_id < this->graph->vertexCount(); i_id++)
+        {
+            neighbours.clear();
+            this->graph->neighbours(i_id, neighbours);
+            for (uint32_t j_id : neighbours)
+            {
+                if (i_id < j_id)
+                {
+                    tempClause.clear();
+                    for (int j = 0; j < k; j++)
+                    {
+                        tempClause.push(literals_table[i_id][j]);
+                        tempClause.push(literals_table[j_id][j]);
+                    }
+                    solver->addClause(tempClause);
+                }
+            }
+        }
+        trace.arg("k", k);
+        trace.arg("clauses", solver->nClauses());
+    }
+
+    void interrupt()
+    {
+        this->solver->interrupt();
+    }
+
+    void clearInterrupt()
+    {
+        this->solver->clearInterrupt();
+    }
+
+    void setBudget(int64_t conflicts)
+    {
+        if (conflicts < 0)
+            this->solver->budgetOff();
+        else
+            this->solver->setConfBudget(conflicts);
+    }
+
+    // summed over the solvers of every probe, since prepare() replaces the solver
+    uint64_t conflicts()
+    {
+        return this->spent;
+    }
+
+    Minisat::lbool solve(vector<int> &cover)
+    {
+        TraceScope trace(this->tracer, "solve", "cnf");
+        Minisat::vec<Minisat::Lit> no_assumptions;
+        SolverCounters before(this->solver.get());
+        Minisat::lbool res = this->solver->solveLimited(no_assumptions);
+        this->spent += this->solver->conflicts - before.conflicts;
+        trace.arg("k", this->k);
+        trace.arg("sat", res == l_True);
+        trace.solver(before, this->solver.get());
+        if (res == l_True)
+        {
+            TraceScope decode(this->tracer, "decode", "cnf");
+            cover.clear();
+            for (unsigned int i = 0; i < this->literals_table.size(); i++)
+            {
+                for (int j = 0; j < this->k; j++)
+                {
+                    if (Minisat::toInt(this->solver->modelValue(this->literals_table[i][j])) == 0)
+                    {
+                        cover.push_back(i);
+                        break;
+                    }
+                }
+            }
+        }
+        return res;
+    }
+};
+
+static VCEncoding *make_member_encoding(const Graph *graph, EncodingMode encoding, int width, int config, Tracer *tracer)
+{
+    if (encoding == ENCODING_COUNTER)
+        return new CounterEncoding(graph, width, config, tracer);
+    return new PairwiseEncoding(graph, config, tracer);
+}
+
+// PortfolioEncoding Class
+// Races differently configured copies of the selected encoding on the same k. Every member
+// prepares and solves on its own thread; the first definite answer wins and the others are
+// interrupted. Members are only interrupted while registered as running, because the
+// pairwise encoding replaces its solver in prepare().
+class PortfolioEncoding : public VCEncoding
+{
+private:
+    vector<std::unique_ptr<VCEncoding>> members;
+    vector<bool> running;
+    pthread_mutex_t lock;
+    bool cancelled = false;
+    bool decided = false;
+    int k = 0;
+    int64_t budget = -1;
+    Minisat::lbool result;
+    vector<int> winner;
+
+    struct RaceArg
+    {
+        PortfolioEncoding *portfolio;
+        int id;
+    };
+
+    void race(int id)
+    {
+        VCEncoding *member = this->members[id].get();
+        member->prepare(this->k);
+        pthread_mutex_lock(&this->lock);
+        if (this->decided || this->cancelled)
+        {
+            pthread_mutex_unlock(&this->lock);
+            return;
+        }
+        member->clearInterrupt();
+        member->setBudget(this->budget);
+        this->running[id] = true;
+        pthread_mutex_unlock(&this->lock);
+
+        vector<int> found;
+        Minisat::lbool res = member->solve(found);
+
+        pthread_mutex_lock(&this->lock);
+        this->running[id] = false;
+        if (res != l_Undef && !this->decided)
+        {
+            this->decided = true;
+            this->result = res;
+            this->winner.swap(found);
+            for (unsigned int i = 0; i < this->members.size(); i++)
+            {
+                if (this->running[i])
+                    this->members[i]->interrupt();
+            }
+        }
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    static void *racer(void *arg)
+    {
+        RaceArg *r = (RaceArg *)arg;
+        r->portfolio->race(r->id);
+        return NULL;
+    }
+
+public:
+    PortfolioEncoding(const Graph *graph, EncodingMode encoding, int width, int size, Tracer *tracer)
+    {
+        for (int i = 0; i < size; i++)
+            this->members.push_back(std::unique_ptr<VCEncoding>(make_member_encoding(graph, encoding, width, i, tracer)));
+        this->running.assign(size, false);
+        pthread_mutex_init(&this->lock, NULL);
+    }
+
+    ~PortfolioEncoding()
+    {
+        pthread_mutex_destroy(&this->lock);
+    }
+
+    void prepare(int k)
+    {
+        this->k = k;
+    }
+
+    Minisat::lbool solve(vector<int> &cover)
+    {
+        this->result = l_Undef;
+        this->decided = false;
+        int size = this->members.size();
+        vector<pthread_t> threads(size);
+        vector<RaceArg> args(size);
+        for (int i = 0; i < size; i++)
+        {
+            args[i].portfolio = this;
+            args[i].id = i;
+            pthread_create(&threads[i], NULL, &PortfolioEncoding::racer, &args[i]);
+        }
+        for (int i = 0; i < size; i++)
+            pthread_join(threads[i], NULL);
+        if (this->result == l_True)
+            cover = this->winner;
+        return this->result;
+    }
+
+    void interrupt()
+    {
+        pthread_mutex_lock(&this->lock);
+        this->cancelled = true;
+        for (unsigned int i = 0; i < this->members.size(); i++)
+        {
+            if (this->running[i])
+                this->members[i]->interrupt();
+        }
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    void clearInterrupt()
+    {
+        pthread_mutex_lock(&this->lock);
+        this->cancelled = false;
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    void learn(int lo, int hi)
+    {
+        for (std::unique_ptr<VCEncoding> &member : this->members)
+            member->learn(lo, hi);
+    }
+
+    // every member gets the whole budget; what they spend together is charged to the run
+    void setBudget(int64_t conflicts)
+    {
+        this->budget = conflicts;
+    }
+
+    uint64_t conflicts()
+    {
+        uint64_t total = 0;
+        for (std::unique_ptr<VCEncoding> &member : this->members)
+            total += member->conflicts();
+        return total;
+    }
+};
+
+static VCEncoding *make_encoding(const Graph *graph, int width, const SolverOptions &options)
+{
+    if (options.portfolio > 1)
+        return new PortfolioEncoding(graph, options.encoding, width, options.portfolio, options.tracer);
+    return make_member_encoding(graph, options.encoding, width, 0, options.tracer);
+}
+
+// Binary search for the smallest k with a cover. No cover is smaller than lo, cover holds
+// the best cover found so far and hi is its size (n + 1 while there is none). Returns the
+// proven lower bound, which is below hi when the run was cancelled or ran out of budget.
+static int cnf_sat_vc_search(const Graph *graph, VCEncoding *encoding, int lo, int hi, vector<int> &cover, SolveControl *control)
+{
+    vector<int> found;
+    while (lo < hi)
+    {
+        int k = (lo + hi - 1) / 2;
+        encoding->prepare(k);
+        if (!control->enter(encoding))
+            break;
+        uint64_t before = encoding->conflicts();
+        Minisat::lbool res = encoding->solve(found);
+        control->leave(encoding, encoding->conflicts() - before);
+        if (res == l_True)
+        {
+            cover = found;
+            hi = cover.size();
+        }
+        else if (res == l_False)
+            lo = k + 1;
+        else
+            break;
+        if (control->improve(graph, cover))
+            hi = cover.size();
+        encoding->learn(lo, hi);
+    }
+    return lo;
+}
+
+// ProbeSearch Class
+// Speculative parallel binary search: several workers probe different k at once, each
+// with its own encoding. Probes are spread over the widest open gap between the known
+// bounds and the k already in flight, and a probe whose k falls outside [lo, hi) after
+// another answer is interrupted.
+class ProbeSearch
+{
+private:
+    const Graph *graph;
+    SolveControl *control;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int lo, hi, width;
+    bool stopped = false;
+    vector<int> *cover;
+    vector<int> active_k;
+    vector<VCEncoding *> active_encoding;
+
+    struct WorkerArg
+    {
+        ProbeSearch *search;
+        int id;
+    };
+
+    // midpoint of the widest gap between lo - 1, the k in flight and hi; -1 if none is open
+    int nextProbe()
+    {
+        vector<int> points(1, this->lo - 1);
+        for (int k : this->active_k)
+        {
+            if (k >= this->lo && k < this->hi)
+                points.push_back(k);
+        }
+        points.push_back(this->hi);
+        sort(points.begin(), points.end());
+        int gap = 1, k = -1;
+        for (unsigned int i = 1; i < points.size(); i++)
+        {
+            if (points[i] - points[i - 1] > gap)
+            {
+                gap = points[i] - points[i - 1];
+                k = (points[i - 1] + points[i]) / 2;
+            }
+        }
+        return k;
+    }
+
+    void cancelIrrelevant()
+    {
+        for (unsigned int w = 0; w < this->active_k.size(); w++)
+        {
+            int k = this->active_k[w];
+            if (k != -1 && (k < this->lo || k >= this->hi) && this->active_encoding[w] != NULL)
+                this->active_encoding[w]->interrupt();
+        }
+    }
+
+    void work(int id)
+    {
+        std::unique_ptr<VCEncoding> encoding(make_encoding(this->graph, this->width, this->control->options()));
+        vector<int> found;
+        pthread_mutex_lock(&this->lock);
+        while (this->lo < this->hi && !this->stopped)
+        {
+            int k = this->nextProbe();
+            if (k == -1)
+            {
+                pthread_cond_wait(&this->changed, &this->lock);
+                continue;
+            }
+            this->active_k[id] = k;
+            pthread_mutex_unlock(&this->lock);
+            encoding->prepare(k);
+            pthread_mutex_lock(&this->lock);
+            if (k < this->lo || k >= this->hi)
+            {
+                this->active_k[id] = -1;
+                continue;
+            }
+            encoding->learn(this->lo, this->hi);
+            if (!this->control->enter(encoding.get()))
+            {
+                // cancelled or out of conflicts: wake the others so they stop too
+                this->active_k[id] = -1;
+                this->stopped = true;
+                pthread_cond_broadcast(&this->changed);
+                break;
+            }
+            this->active_encoding[id] = encoding.get();
+            pthread_mutex_unlock(&this->lock);
+
+            uint64_t before = encoding->conflicts();
+            Minisat::lbool res = encoding->solve(found);
+            this->control->leave(encoding.get(), encoding->conflicts() - before);
+
+            pthread_mutex_lock(&this->lock);
+            this->active_encoding[id] = NULL;
+            this->active_k[id] = -1;
+            if (res == l_True && (int)found.size() < this->hi)
+            {
+                this->hi = found.size();
+                *this->cover = found;
+            }
+            else if (res == l_False && k + 1 > this->lo)
+                this->lo = k + 1;
+            else if (res == l_Undef && k >= this->lo && k < this->hi)
+                this->stopped = true;
+            if (this->control->improve(this->graph, *this->cover))
+                this->hi = this->cover->size();
+            this->cancelIrrelevant();
+            pthread_cond_broadcast(&this->changed);
+        }
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    static void *worker(void *arg)
+    {
+        WorkerArg *w = (WorkerArg *)arg;
+        w->search->work(w->id);
+        return NULL;
+    }
+
+public:
+    ProbeSearch(const Graph *graph, SolveControl *control)
+    {
+        this->graph = graph;
+        this->control = control;
+        pthread_mutex_init(&this->lock, NULL);
+        pthread_cond_init(&this->changed, NULL);
+    }
+
+    ~ProbeSearch()
+    {
+        pthread_mutex_destroy(&this->lock);
+        pthread_cond_destroy(&this->changed);
+    }
+
+    // returns the proven lower bound, as cnf_sat_vc_search does
+    int run(int threads, int lo, int hi, vector<int> &cover)
+    {
+        this->lo = lo;
+        this->hi = hi;
+        this->width = hi;
+        this->cover = &cover;
+        this->active_k.assign(threads, -1);
+        this->active_encoding.assign(threads, NULL);
+        vector<pthread_t> workers(threads);
+        vector<WorkerArg> args(threads);
+        for (int i = 0; i < threads; i++)
+        {
+            args[i].search = this;
+            args[i].id = i;
+            pthread_create(&workers[i], NULL, &ProbeSearch::worker, &args[i]);
+        }
+        for (int i = 0; i < threads; i++)
+            pthread_join(workers[i], NULL);
+        return this->lo;
+    }
+};
+
+// Graphs small and dense enough for DenseSolver, where the pairwise clauses grow fastest
+static bool dense_eligible(const Graph *graph, double threshold)
+{
+    uint64_t n = graph->vertexCount();
+    if (threshold <= 0 || n < 2 || n > DenseSolver::MAX_VERTICES)
+        return false;
+    return 2.0 * graph->edgeCount() >= threshold * n * (n - 1);
+}
+
+// CNF-SAT-VC; returns the proven lower bound, equal to the cover's size when it is optimal
+static int cnf_sat_vc_solve(const Graph *graph, vector<int> &cover, SolveControl *control)
+{
+    const SolverOptions &options = control->options();
+    if (dense_eligible(graph, options.dense_threshold))
+    {
+        TraceScope trace(options.tracer, "dense", "cnf");
+        vector<int> upper;
+        max_degree_greedy_cover(graph, upper);
+        control->improve(graph, upper);
+        CSR_DISPATCH(graph, view, DenseSolver solver(view, control); return solver.solve(upper, cover));
+    }
+
+    // the counter encoding starts from a maximal matching cover, which also bounds its width
+    cover.clear();
+    int lo = 1;
+    int hi = graph->vertexCount() + 1;
+    if (options.bounds)
+    {
+        // a matching of size m needs m cover vertices, and the LP bound is often tighter;
+        // the smallest of the matching, greedy and offered covers is the incumbent
+        maximal_matching_cover(graph, cover);
+        lo = std::max<int>(cover.size() / 2, lp_lower_bound(graph));
+        vector<int> greedy;
+        max_degree_greedy_cover(graph, greedy);
+        if (greedy.size() < cover.size())
+            cover.swap(greedy);
+        control->improve(graph, cover);
+        hi = cover.size();
+    }
+    else if (options.encoding == ENCODING_COUNTER)
+    {
+        maximal_matching_cover(graph, cover);
+        hi = cover.size();
+    }
+    // after an incremental edit the search only spans the distance to the previous optimum
+    if (!options.bounds && control->improve(graph, cover))
+        hi = cover.size();
+    lo = std::max<int>(lo, control->lowerBound(graph));
+    if (hi <= lo)
+        return cover.size();
+
+    if (options.probe_threads > 1)
+    {
+        ProbeSearch search(graph, control);
+        lo = search.run(options.probe_threads, lo, hi, cover);
+    }
+    else
+    {
+        std::unique_ptr<VCEncoding> encoding(make_encoding(graph, hi, options));
+        lo = cnf_sat_vc_search(graph, encoding.get(), lo, hi, cover, control);
+    }
+    // stopped before any probe was satisfiable: the matching cover is the best known
+    if (cover.empty())
+        maximal_matching_cover(graph, cover);
+    return std::min<int>(lo, cover.size());
+}
+
+// CNF-SAT-VC with the optional kernelization stage in front
+static void cnf_sat_vc_exact(const Graph *graph, vector<int> &cover, SolveStats *stats, SolveControl *control)
+{
+    if (control->options().kernel)
+    {
+        long double start = pclock(CLOCK_THREAD_CPUTIME_ID);
+        Kernel kernel;
+        {
+            TraceScope trace(control->options().tracer, "kernel", "cnf");
+            vector<int> upper;
+            maximal_matching_cover(graph, upper);
+            kernel.reduce(graph, upper.size());
+            trace.arg("vertices", graph->vertexCount());
+            trace.arg("kernel_vertices", kernel.graph.vertexCount());
+        }
+        stats->kernel_time += pclock(CLOCK_THREAD_CPUTIME_ID) - start;
+        stats->kernel_vertices += kernel.graph.vertexCount();
+
+        vector<int> kernel_cover;
+        int lo = cnf_sat_vc_solve(&kernel.graph, kernel_cover, control);
+        kernel.lift(kernel_cover, cover);
+        stats->lower_bound += lo + kernel.forcedCount();
+    }
+    else
+        stats->lower_bound += cnf_sat_vc_solve(graph, cover, control);
+    stats->complete = stats->complete && stats->lower_bound >= cover.size();
+}
+
+template <class G>
+static uint32_t bnb_vc_search(const G *graph, const vector<int> &upper, vector<int> &cover, SolveControl *control)
+{
+    BranchAndReduce<G> engine(graph, control);
+    return engine.solve(upper, cover);
+}
+
+// BNB-VC from a max-degree greedy incumbent
+static void bnb_vc_exact(const Graph *graph, vector<int> &cover, SolveStats *stats, SolveControl *control)
+{
+    vector<int> upper;
+    max_degree_greedy_cover(graph, upper);
+    control->improve(graph, upper);
+    CSR_DISPATCH(graph, view, stats->lower_bound += bnb_vc_search(view, upper, cover, control));
+    stats->complete = stats->complete && stats->lower_bound >= cover.size();
+}
+
+typedef void (*ExactSolver)(const Graph *, vector<int> &, SolveStats *, SolveControl *);
+
+// ComponentSolver Class
+// Runs an exact solver on every connected component using a fixed pool of threads, largest
+// components first, and merges the partial covers in input ids. Stars, including single
+// edges, are answered directly with their centre.
+class ComponentSolver
+{
+private:
+    const vector<Component> *components;
+    ExactSolver solver;
+    SolveControl *control;
+    vector<size_t> order;
+    size_t next = 0;
+    pthread_mutex_t lock;
+    vector<vector<int>> covers;
+    vector<SolveStats> stats;
+
+    void work()
+    {
+        while (true)
+        {
+            pthread_mutex_lock(&this->lock);
+            if (this->next == this->order.size())
+            {
+                pthread_mutex_unlock(&this->lock);
+                return;
+            }
+            size_t i = this->order[this->next++];
+            pthread_mutex_unlock(&this->lock);
+            const Component &c = (*this->components)[i];
+            this->solver(&c.graph, this->covers[i], &this->stats[i], this->control);
+        }
+    }
+
+    static void *worker(void *arg)
+    {
+        ((ComponentSolver *)arg)->work();
+        return NULL;
+    }
+
+public:
+    ComponentSolver()
+    {
+        pthread_mutex_init(&this->lock, NULL);
+    }
+
+    ~ComponentSolver()
+    {
+        pthread_mutex_destroy(&this->lock);
+    }
+
+    void run(const vector<Component> &components, ExactSolver solver, int threads, vector<int> &cover, SolveStats *total, SolveControl *control)
+    {
+        this->components = &components;
+        this->solver = solver;
+        this->control = control;
+        this->covers.assign(components.size(), vector<int>());
+        this->stats.assign(components.size(), SolveStats());
+        this->order.clear();
+        this->next = 0;
+        for (size_t i = 0; i < components.size(); i++)
+        {
+            const Component &c = components[i];
+            uint32_t size = c.graph.vertexCount();
+            int centre = -1;
+            if (c.graph.edgeCount() == size - 1)
+            {
+                for (uint32_t v = 0; v < size && centre == -1; v++)
+                {
+                    if (c.graph.degree(v) == size - 1)
+                        centre = v;
+                }
+            }
+            if (centre != -1)
+            {
+                this->covers[i].push_back(centre);
+                this->stats[i].lower_bound = 1;
+            }
+            else
+                this->order.push_back(i);
+        }
+        sort(this->order.begin(), this->order.end(), [&components](size_t a, size_t b) {
+            return components[a].graph.edgeCount() > components[b].graph.edgeCount();
+        });
+
+        vector<pthread_t> workers(threads);
+        for (int i = 0; i < threads; i++)
+            pthread_create(&workers[i], NULL, &ComponentSolver::worker, this);
+        for (int i = 0; i < threads; i++)
+            pthread_join(workers[i], NULL);
+
+        cover.clear();
+        for (size_t i = 0; i < components.size(); i++)
+        {
+            for (int id : this->covers[i])
+                cover.push_back(components[i].origin[id]);
+            total->kernel_time += this->stats[i].kernel_time;
+            total->kernel_vertices += this->stats[i].kernel_vertices;
+            total->lower_bound += this->stats[i].lower_bound;
+            total->complete = total->complete && this->stats[i].complete;
+        }
+    }
+};
+
+// Runs an exact solver on the whole graph, or per component when -components is set
+static void exact_cover(ExactSolver solver, const Graph *graph, const vector<Component> &components, vector<int> &cover, SolveStats *stats, SolveControl *control)
+{
+    int threads = control->options().component_threads;
+    if (threads > 0)
+    {
+        ComponentSolver pool;
+        pool.run(components, solver, threads, cover, stats, control);
+    }
+    else
+        solver(graph, cover, stats, control);
+}
+
+// LS-VC: local search from the valid cover start for the given seconds
+template <class G>
+static void ls_vc_search(const G *graph, const vector<int> &start, double seconds, vector<int> &cover)
+{
+    LocalSearch<G> search(graph);
+    search.solve(start, seconds, cover);
+}
+
+static void ls_vc_search(const Graph *graph, const vector<int> &start, double seconds, vector<int> &cover)
+{
+    CSR_DISPATCH(graph, view, ls_vc_search(view, start, seconds, cover));
+}
+
+// LS-VC from the greedy cover
+template <class G>
+static void ls_vc_cover(const G *graph, double seconds, vector<int> &cover)
+{
+    vector<int> start;
+    max_degree_greedy_cover(graph, start);
+    ls_vc_search(graph, start, seconds, cover);
+}
+
+static void ls_vc_cover(const Graph *graph, double seconds, vector<int> &cover)
+{
+    CSR_DISPATCH(graph, view, ls_vc_cover(view, seconds, cover));
+}
+
+// APPROX_VC_2: repeatedly takes the highest-degree vertex and its highest-degree neighbour
+template <class G>
+static void approx_vc_2_degree(const G *graph, vector<int> &cover)
+{
+    GraphState<G> state(graph);
+    DegreeQueue<G> queue(&state);
+    int target_1;
+    //selecting a node with the highest degree in our graph
+    while ((target_1 = queue.maxNode()) != -1)
+    {
+        //selecting a node with the highest degree among all nodes that are connected to the target_1 node
+        uint32_t temp_degree = 0;
+        int target_2 = -1;
+        for (const typename G::Id *it = graph->begin(target_1); it != graph->end(target_1); ++it)
+        {
+            if (temp_degree < state.degree(*it))
+            {
+                temp_degree = state.degree(*it);
+                target_2 = *it;
+            }
+        }
+
+        cover.push_back(target_1);
+        cover.push_back(target_2);
+
+        queue.removeVertex(target_1);
+        queue.removeVertex(target_2);
+    }
+}
+
+static void approx_vc_2_degree(const Graph *graph, vector<int> &cover)
+{
+    CSR_DISPATCH(graph, view, approx_vc_2_degree(view, cover));
+}
+
+static void approx_vc_2_cover(const Graph *graph, const vector<Edge> &edges, Approx2Mode mode, vector<int> &cover)
+{
+    if (mode == APPROX2_MATCHING)
+    {
+        // binary inputs come without an edge list, so fall back to the CSR arrays
+        if (edges.empty())
+            maximal_matching_cover(graph, cover);
+        else
+            maximal_matching_cover(edges, graph->vertexCount(), cover);
+    }
+    else
+        approx_vc_2_degree(graph, cover);
+}
+
+} // namespace vc
+
+#endif
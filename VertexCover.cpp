@@ -0,0 +1,191 @@
+// VertexCover.cpp
+// The vertexcover library: the VertexCoverSolver classes on top of the solvers in Solvers.h.
+// Each solve() builds its own Graph and SolveControl, so concurrent solves share nothing
+// but the exact solvers' registry of running controls that cancel() walks.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function" // helpers only the main program uses
+#include "Solvers.h"
+#pragma GCC diagnostic pop
+
+namespace vc
+{
+
+// Copies the view's edges and builds its graph; false with result.error set when an edge
+// has an endpoint out of range or is a self-loop, which Graph::build must never see
+static bool build_graph(const GraphView &view, Graph &graph, vector<Edge> &edges, SolveResult &result)
+{
+    for (size_t i = 0; i < view.edge_count; i++)
+    {
+        const Edge &e = view.edges[i];
+        if (e.first >= view.vertices || e.second >= view.vertices || e.first == e.second)
+        {
+            result.error = "invalid edge <" + to_string(e.first) + "," + to_string(e.second) + ">";
+            return false;
+        }
+    }
+    edges.assign(view.edges, view.edges + view.edge_count);
+    graph.build(view.vertices, edges);
+    return true;
+}
+
+// One exact solve on its own thread, which the caller joins until the time budget runs out
+struct ExactRun
+{
+    ExactSolver solver;
+    const Graph *graph;
+    const vector<Component> *components;
+    SolveControl *control;
+    SolveStats stats;
+    SolveResult *result;
+};
+
+static void *exact_run(void *arg)
+{
+    ExactRun *run = (ExactRun *)arg;
+    exact_cover(run->solver, run->graph, *run->components, run->result->cover, &run->stats, run->control);
+    run->result->cpu_time = pclock(CLOCK_THREAD_CPUTIME_ID);
+    return NULL;
+}
+
+ExactVCSolver::ExactVCSolver(bool bnb, const SolverOptions &options) : bnb(bnb), options(options)
+{
+    pthread_mutex_init(&this->lock, NULL);
+}
+
+ExactVCSolver::~ExactVCSolver()
+{
+    pthread_mutex_destroy(&this->lock);
+}
+
+SolveResult ExactVCSolver::solve(const GraphView &view)
+{
+    SolveResult result;
+    long double start = pclock(CLOCK_MONOTONIC);
+    Graph graph;
+    vector<Edge> edges;
+    if (!build_graph(view, graph, edges, result))
+        return result;
+    if (view.edge_count > 0)
+    {
+        vector<Component> components;
+        if (this->options.component_threads > 0)
+            split_components(&graph, components);
+
+        SolveControl control;
+        control.reset(this->options, &graph);
+        pthread_mutex_lock(&this->lock);
+        this->active.insert(&control);
+        pthread_mutex_unlock(&this->lock);
+
+        ExactRun run;
+        run.solver = this->bnb ? &bnb_vc_exact : &cnf_sat_vc_exact;
+        run.graph = &graph;
+        run.components = &components;
+        run.control = &control;
+        run.result = &result;
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &exact_run, &run) != 0)
+        {
+            // no thread to time: solve here, bounded by the conflict budget and cancel() only
+            long double cpu = pclock(CLOCK_THREAD_CPUTIME_ID);
+            exact_run(&run);
+            result.cpu_time -= cpu;
+        }
+        else
+        {
+            // past the deadline the solve is cancelled and returns its best cover so far; an
+            // unreadable clock leaves it to the conflict budget and cancel()
+            struct timespec ts;
+            bool timed = this->options.time_budget > 0 && budget_deadline(this->options.time_budget, ts);
+            if (!timed || pthread_timedjoin_np(thread, NULL, &ts) != 0)
+            {
+                if (timed)
+                    control.cancel();
+                pthread_join(thread, NULL);
+            }
+        }
+        pthread_mutex_lock(&this->lock);
+        this->active.erase(&control);
+        pthread_mutex_unlock(&this->lock);
+        result.lower_bound = run.stats.lower_bound;
+        result.kernel_time = run.stats.kernel_time;
+        result.kernel_vertices = run.stats.kernel_vertices;
+    }
+    result.optimal = result.lower_bound >= result.cover.size();
+    result.wall_time = pclock(CLOCK_MONOTONIC) - start;
+    return result;
+}
+
+void ExactVCSolver::cancel()
+{
+    pthread_mutex_lock(&this->lock);
+    for (SolveControl *control : this->active)
+        control->cancel();
+    pthread_mutex_unlock(&this->lock);
+}
+
+// Heuristics run on the calling thread, so its CPU clock times them
+SolveResult Approx1VCSolver::solve(const GraphView &view)
+{
+    SolveResult result;
+    long double start = pclock(CLOCK_MONOTONIC), cpu = pclock(CLOCK_THREAD_CPUTIME_ID);
+    Graph graph;
+    vector<Edge> edges;
+    if (!build_graph(view, graph, edges, result))
+        return result;
+    max_degree_greedy_cover(&graph, result.cover);
+    result.optimal = view.edge_count == 0;
+    result.cpu_time = pclock(CLOCK_THREAD_CPUTIME_ID) - cpu;
+    result.wall_time = pclock(CLOCK_MONOTONIC) - start;
+    return result;
+}
+
+SolveResult Approx2VCSolver::solve(const GraphView &view)
+{
+    SolveResult result;
+    long double start = pclock(CLOCK_MONOTONIC), cpu = pclock(CLOCK_THREAD_CPUTIME_ID);
+    Graph graph;
+    vector<Edge> edges;
+    if (!build_graph(view, graph, edges, result))
+        return result;
+    approx_vc_2_cover(&graph, edges, this->options.approx2, result.cover);
+    // both variants take the two endpoints of a matching's edges
+    result.lower_bound = result.cover.size() / 2;
+    result.optimal = view.edge_count == 0;
+    result.cpu_time = pclock(CLOCK_THREAD_CPUTIME_ID) - cpu;
+    result.wall_time = pclock(CLOCK_MONOTONIC) - start;
+    return result;
+}
+
+SolveResult LsVCSolver::solve(const GraphView &view)
+{
+    SolveResult result;
+    long double start = pclock(CLOCK_MONOTONIC), cpu = pclock(CLOCK_THREAD_CPUTIME_ID);
+    Graph graph;
+    vector<Edge> edges;
+    if (!build_graph(view, graph, edges, result))
+        return result;
+    if (view.edge_count > 0)
+        ls_vc_cover(&graph, this->options.ls_time, result.cover);
+    result.optimal = view.edge_count == 0;
+    result.cpu_time = pclock(CLOCK_THREAD_CPUTIME_ID) - cpu;
+    result.wall_time = pclock(CLOCK_MONOTONIC) - start;
+    return result;
+}
+
+VertexCoverSolver *make_solver(const std::string &name, const SolverOptions &options)
+{
+    if (name == "CNF-SAT-VC")
+        return new CnfSatVCSolver(options);
+    if (name == "BNB-VC")
+        return new BnbVCSolver(options);
+    if (name == "APPROX-VC-1")
+        return new Approx1VCSolver(options);
+    if (name == "APPROX-VC-2")
+        return new Approx2VCSolver(options);
+    if (name == "LS-VC")
+        return new LsVCSolver(options);
+    return NULL;
+}
+
+} // namespace vc
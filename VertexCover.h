@@ -0,0 +1,196 @@
+// VertexCover.h
+// Embeddable minimum vertex cover solvers, built as the vertexcover static library. Every
+// solve() owns the state of its run, so any number of solves can run concurrently in one
+// process, on one solver object or on several.
+#ifndef VERTEX_COVER_H
+#define VERTEX_COVER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vc
+{
+
+// APPROX-VC-2 variants: highest-degree edge heuristic or one-pass maximal matching
+enum Approx2Mode
+{
+    APPROX2_DEGREE,
+    APPROX2_MATCHING
+};
+
+// CNF-SAT-VC encodings: n*k position table with pairwise at-most-one clauses, rebuilt
+// per k, or one variable per vertex with a sequential counter probed by assumptions
+enum EncodingMode
+{
+    ENCODING_PAIRWISE,
+    ENCODING_COUNTER
+};
+
+class Tracer;
+
+// SolverOptions
+// Tuning of the solvers. Each field is the command line option of the same name, with the
+// same default.
+struct SolverOptions
+{
+    Approx2Mode approx2 = APPROX2_DEGREE;
+    EncodingMode encoding = ENCODING_PAIRWISE;
+    bool kernel = false;
+    bool bounds = false;
+    // racing solver configurations per CNF-SAT-VC probe, and parallel probes
+    int portfolio = 1;
+    int probe_threads = 1;
+    // threads solving connected components separately, 0 to solve the whole graph
+    int component_threads = 0;
+    // minimum density for the clique search on small graphs, 0 to disable it
+    double dense_threshold = 0.1;
+    // seconds of local search for LS-VC
+    double ls_time = 0;
+    // wall-clock seconds and SAT conflicts an exact solve may spend before it returns its
+    // best cover so far; a budget of 0 or -1 respectively is unlimited
+    double time_budget = 10;
+    int64_t conflict_budget = -1;
+    // -trace: where the solvers record their phases, NULL for no tracing; it must outlive
+    // every solve that uses it
+    Tracer *tracer = NULL;
+};
+
+// GraphView
+// Undirected graph on the vertices 0 .. vertices - 1, borrowing the caller's edge list for
+// the duration of solve(). Both endpoints of every edge must be below vertices and differ;
+// solve() checks this first and answers a view that breaks it with SolveResult::error.
+// Repeated edges are allowed.
+struct GraphView
+{
+    uint32_t vertices;
+    const std::pair<uint32_t, uint32_t> *edges;
+    size_t edge_count;
+
+    GraphView(uint32_t vertices, const std::vector<std::pair<uint32_t, uint32_t>> &edges)
+        : vertices(vertices), edges(edges.data()), edge_count(edges.size())
+    {
+    }
+};
+
+// SolveResult
+// A cover with what is known about it. Times are in microseconds, like -calc output.
+struct SolveResult
+{
+    // why there is no cover, e.g. "invalid edge <1,1>"; empty after a successful solve
+    std::string error;
+    std::vector<int> cover;
+    // no cover is smaller than lower_bound; optimal when it reaches the cover's size
+    uint32_t lower_bound = 0;
+    bool optimal = false;
+    // CPU time of the solving thread, and wall-clock time of solve(); a clock that cannot
+    // be read counts as 0
+    long double cpu_time = 0;
+    long double wall_time = 0;
+    // -kernel only: reduction time (part of cpu_time) and vertices left in the kernel
+    long double kernel_time = 0;
+    uint32_t kernel_vertices = 0;
+};
+
+class SolveControl;
+
+// VertexCoverSolver Class
+// One vertex cover algorithm with fixed options. solve() blocks the calling thread; cancel()
+// may be called from any other thread and makes every running solve() return its best cover.
+class VertexCoverSolver
+{
+public:
+    virtual ~VertexCoverSolver() {}
+    // the algorithm's name in the program's output, e.g. "CNF-SAT-VC"
+    virtual const char *name() const = 0;
+    virtual SolveResult solve(const GraphView &graph) = 0;
+    virtual void cancel() {}
+};
+
+// ExactVCSolver Class
+// Common part of CNF-SAT-VC and BNB-VC: the solve runs on a thread of its own, bounded by
+// the time and conflict budgets. Each solve() has its own SolveControl, registered in
+// active while it runs so that cancel() reaches it.
+class ExactVCSolver : public VertexCoverSolver
+{
+private:
+    bool bnb;
+    SolverOptions options;
+    pthread_mutex_t lock;
+    std::set<SolveControl *> active;
+
+protected:
+    ExactVCSolver(bool bnb, const SolverOptions &options);
+
+public:
+    ~ExactVCSolver();
+    SolveResult solve(const GraphView &graph);
+    void cancel();
+};
+
+// CNF-SAT-VC: binary search over k with a SAT solver, or the clique search on small dense
+// graphs
+class CnfSatVCSolver : public ExactVCSolver
+{
+public:
+    CnfSatVCSolver(const SolverOptions &options = SolverOptions()) : ExactVCSolver(false, options) {}
+    const char *name() const { return "CNF-SAT-VC"; }
+};
+
+// BNB-VC: branch and reduce
+class BnbVCSolver : public ExactVCSolver
+{
+public:
+    BnbVCSolver(const SolverOptions &options = SolverOptions()) : ExactVCSolver(true, options) {}
+    const char *name() const { return "BNB-VC"; }
+};
+
+// APPROX-VC-1: max-degree greedy
+class Approx1VCSolver : public VertexCoverSolver
+{
+public:
+    Approx1VCSolver(const SolverOptions & = SolverOptions()) {}
+    const char *name() const { return "APPROX-VC-1"; }
+    SolveResult solve(const GraphView &graph);
+};
+
+// APPROX-VC-2: highest-degree edge or maximal matching, by options.approx2
+class Approx2VCSolver : public VertexCoverSolver
+{
+private:
+    SolverOptions options;
+
+public:
+    Approx2VCSolver(const SolverOptions &options = SolverOptions()) : options(options) {}
+    const char *name() const { return "APPROX-VC-2"; }
+    SolveResult solve(const GraphView &graph);
+};
+
+// LS-VC: local search from the greedy cover for options.ls_time seconds
+class LsVCSolver : public VertexCoverSolver
+{
+private:
+    SolverOptions options;
+
+public:
+    LsVCSolver(const SolverOptions &options = SolverOptions()) : options(options) {}
+    const char *name() const { return "LS-VC"; }
+    SolveResult solve(const GraphView &graph);
+};
+
+// The solver with the given output name, NULL for an unknown one; the caller owns it
+VertexCoverSolver *make_solver(const std::string &name, const SolverOptions &options = SolverOptions());
+
+// Parses the option at argv[i] into options, advancing i past its value, for programs that
+// take prjece650's solver options. Returns 1 when it was consumed, 0 when argv[i] is not a
+// solver option and -1 after reporting a bad value on cerr. -bnb selects an algorithm
+// rather than tuning one, so it is left to the caller.
+int parse_solver_option(int argc, char *argv[], int &i, SolverOptions &options);
+
+} // namespace vc
+
+#endif